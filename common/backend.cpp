@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+
+#include "backend.hpp"
+#include "pngwrite.hpp"
+
+extern GLFWwindow *window;
+
+int frameWidth = 0;
+int frameHeight = 0;
+
+RenderBackend activeBackend = BACKEND_WINDOW;
+
+// Framebuffer object the offscreen backend renders into
+GLuint OffscreenFramebufferID = 0;
+GLuint OffscreenColorBufferID = 0;
+GLuint OffscreenDepthBufferID = 0;
+
+static bool createOffscreenFramebuffer()
+{
+	glGenRenderbuffers(1, &OffscreenColorBufferID);
+	glBindRenderbuffer(GL_RENDERBUFFER, OffscreenColorBufferID);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, frameWidth, frameHeight);
+
+	glGenRenderbuffers(1, &OffscreenDepthBufferID);
+	glBindRenderbuffer(GL_RENDERBUFFER, OffscreenDepthBufferID);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, frameWidth, frameHeight);
+
+	glGenFramebuffers(1, &OffscreenFramebufferID);
+	glBindFramebuffer(GL_FRAMEBUFFER, OffscreenFramebufferID);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, OffscreenColorBufferID);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, OffscreenDepthBufferID);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Offscreen framebuffer is incomplete\n");
+		return false;
+	}
+
+	// Everything is drawn into the framebuffer object from now on
+	glViewport(0, 0, frameWidth, frameHeight);
+	return true;
+}
+
+bool initBackend(RenderBackend backend, int width, int height, const char * title)
+{
+	activeBackend = backend;
+	frameWidth = width;
+	frameHeight = height;
+
+#ifdef GLFW_PLATFORM_NULL
+	// GLFW 3.4+: the null platform needs no display server at all
+	if (backend == BACKEND_OFFSCREEN)
+	{
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+	}
+#endif
+
+	if (!glfwInit())
+	{
+		printf("Failed to initialize GLFW!\n");
+		return false;
+	}
+
+	// Set OpenGL context settings (version and profile)
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	if (backend == BACKEND_WINDOW)
+	{
+		glfwWindowHint(GLFW_SAMPLES, 4); // Anti-aliasing
+		window = glfwCreateWindow(width, height, title, NULL, NULL);
+	}
+	else
+	{
+		// Hidden context, try EGL (surfaceless) first and fall back to OSMesa (llvmpipe)
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+		window = glfwCreateWindow(width, height, title, NULL, NULL);
+		if (window == NULL)
+		{
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+			window = glfwCreateWindow(width, height, title, NULL, NULL);
+		}
+	}
+
+	if (window == NULL)
+	{
+		printf("Failed to open GLFW window!\n");
+		glfwTerminate();
+		return false;
+	}
+
+	glfwMakeContextCurrent(window);
+
+	glewExperimental = true;
+	GLenum glewStatus = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	// Without an X display GLEW still loads the core entry points, only its GLX part fails
+	if (backend == BACKEND_OFFSCREEN && glewStatus == GLEW_ERROR_NO_GLX_DISPLAY)
+	{
+		glewStatus = GLEW_OK;
+	}
+#endif
+	if (glewStatus != GLEW_OK)
+	{
+		printf("Failed to initialize GLEW!\n");
+		glfwTerminate();
+		return false;
+	}
+
+	if (backend == BACKEND_OFFSCREEN && !createOffscreenFramebuffer())
+	{
+		cleanupBackend();
+		return false;
+	}
+
+	return true;
+}
+
+void presentFrame()
+{
+	if (activeBackend == BACKEND_WINDOW)
+	{
+		glfwSwapBuffers(window);
+	}
+	else
+	{
+		glFlush(); // Nothing to show, just make sure the frame gets executed
+	}
+}
+
+void readFrame(std::vector<unsigned char> & pixels)
+{
+	size_t rowSize = static_cast<size_t>(frameWidth) * 3;
+	pixels.resize(rowSize * frameHeight);
+
+	// The window backend reads the frame that is about to be swapped in
+	if (activeBackend == BACKEND_WINDOW)
+	{
+		glReadBuffer(GL_BACK);
+	}
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, frameWidth, frameHeight, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]);
+
+	// OpenGL returns the bottom row first, swap rows so the image reads top to bottom
+	std::vector<unsigned char> row(rowSize);
+	for (int top = 0, bottom = frameHeight - 1; top < bottom; top++, bottom--)
+	{
+		std::copy(&pixels[top * rowSize], &pixels[top * rowSize] + rowSize, row.begin());
+		std::copy(&pixels[bottom * rowSize], &pixels[bottom * rowSize] + rowSize, &pixels[top * rowSize]);
+		std::copy(row.begin(), row.end(), &pixels[bottom * rowSize]);
+	}
+}
+
+bool dumpFrame(const char * path)
+{
+	std::vector<unsigned char> pixels;
+	readFrame(pixels);
+	return writePNG(path, frameWidth, frameHeight, 3, &pixels[0], false);
+}
+
+void cleanupBackend()
+{
+	if (OffscreenFramebufferID)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &OffscreenFramebufferID);
+		glDeleteRenderbuffers(1, &OffscreenColorBufferID);
+		glDeleteRenderbuffers(1, &OffscreenDepthBufferID);
+		OffscreenFramebufferID = 0;
+		OffscreenColorBufferID = 0;
+		OffscreenDepthBufferID = 0;
+	}
+
+	glfwTerminate();
+}
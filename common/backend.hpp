@@ -0,0 +1,32 @@
+#ifndef BACKEND_HPP
+#define BACKEND_HPP
+
+#include <vector>
+
+// Where frames are rendered to
+enum RenderBackend
+{
+	BACKEND_WINDOW,     // Visible GLFW window (default)
+	BACKEND_OFFSCREEN   // Hidden context (EGL or OSMesa, no display needed) rendering into a framebuffer object
+};
+
+// Size of the frames being rendered
+extern int frameWidth;
+extern int frameHeight;
+
+// Create the OpenGL context for the chosen backend and initialize GLEW
+bool initBackend(RenderBackend backend, int width, int height, const char * title);
+
+// Show the finished frame (swaps buffers for the window backend)
+void presentFrame();
+
+// Read back the current frame as RGB pixels, top row first
+void readFrame(std::vector<unsigned char> & pixels);
+
+// Read back the current frame and write it as a PNG file
+bool dumpFrame(const char * path);
+
+// Destroy the framebuffer object (if any) and terminate GLFW
+void cleanupBackend();
+
+#endif
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include "memstats.hpp"
+#include "benchmark.hpp"
+
+double percentile(std::vector<double> samples, double fraction)
+{
+	if (samples.empty())
+		return 0.0;
+
+	// Nearest-rank percentile, only the selected element has to be in place
+	size_t rank = static_cast<size_t>(fraction * (samples.size() - 1) + 0.5);
+	std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+	return samples[rank];
+}
+
+static double mean(const std::vector<double> & samples)
+{
+	double sum = 0.0;
+	for (double sample : samples)
+		sum += sample;
+	return samples.empty() ? 0.0 : sum / samples.size();
+}
+
+static void writeTimings(FILE * file, const char * name, const std::vector<double> & samples)
+{
+	double maximum = samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+	fprintf(file, "  \"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+		name, mean(samples), percentile(samples, 0.50), percentile(samples, 0.90), percentile(samples, 0.95), percentile(samples, 0.99), maximum);
+}
+
+bool writeBenchmarkReport(const char * path, const BenchmarkConfig & config, const BenchmarkResults & results)
+{
+	FILE * file = fopen(path, "w");
+	if (!file)
+	{
+		printf("Impossible to open benchmark report %s\n", path);
+		return false;
+	}
+
+	double totalDrawCalls = 0.0;
+	int maxDrawCalls = 0;
+	for (int drawCalls : results.drawCalls)
+	{
+		totalDrawCalls += drawCalls;
+		maxDrawCalls = std::max(maxDrawCalls, drawCalls);
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"config\": { \"level\": %d, \"duration\": %.2f, \"seed\": %u, \"camera\": %d, \"width\": %d, \"height\": %d, \"headless\": %s },\n",
+		config.level, config.duration, config.seed, config.camera, config.width, config.height, config.headless ? "true" : "false");
+	fprintf(file, "  \"frames\": %d,\n", static_cast<int>(results.frameMs.size()));
+	fprintf(file, "  \"levels_cleared\": %d,\n", results.levelsCleared);
+	fprintf(file, "  \"games_lost\": %d,\n", results.gamesLost);
+	writeTimings(file, "frame_ms", results.frameMs);
+	writeTimings(file, "tick_ms", results.tickMs);
+	fprintf(file, "  \"draw_calls\": { \"mean\": %.2f, \"max\": %d },\n",
+		results.drawCalls.empty() ? 0.0 : totalDrawCalls / results.drawCalls.size(), maxDrawCalls);
+
+	// JSON keys of the memory categories, in MemCategory order
+	static const char * const memoryKeys[MEM_CATEGORY_COUNT] = { "mesh_cpu", "mesh_gpu", "textures", "text_buffers", "entities" };
+	fprintf(file, "  \"memory_peak_bytes\": {");
+	for (int i = 0; i < MEM_CATEGORY_COUNT; i++)
+	{
+		fprintf(file, "%s \"%s\": %zu", i == 0 ? "" : ",", memoryKeys[i], memPeak(static_cast<MemCategory>(i)));
+	}
+	fprintf(file, " }\n");
+	fprintf(file, "}\n");
+
+	bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
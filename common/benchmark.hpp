@@ -0,0 +1,34 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <vector>
+
+// Settings of a benchmark run, given on the command line
+struct BenchmarkConfig
+{
+	int level = 1;              // Level the run starts on, also restarted after a game over
+	double duration = 30.0;     // Seconds of gameplay to measure
+	unsigned int seed = 1;      // Seed of the random number generator (alien and mothership firing)
+	int camera = 1;             // Camera mode (1 = player-focused, 2 = top-down, 3 = free)
+	int width = 1920;           // Framebuffer size
+	int height = 1080;
+	bool headless = false;      // Rendered offscreen instead of to a window
+};
+
+// Measurements collected over a benchmark run, one entry per frame
+struct BenchmarkResults
+{
+	std::vector<double> frameMs;  // Time between two presented frames
+	std::vector<double> tickMs;   // CPU time of the simulation step (input, movement, firing, collisions, removal)
+	std::vector<int> drawCalls;   // Draw calls issued for the frame
+	int levelsCleared = 0;        // Levels won by the scripted player
+	int gamesLost = 0;            // Times the scripted player ran out of lives
+};
+
+// Value below which the given fraction (0..1) of the samples lie
+double percentile(std::vector<double> samples, double fraction);
+
+// Write the run's settings, frame and tick time percentiles, draw calls and memory peaks as JSON
+bool writeBenchmarkReport(const char * path, const BenchmarkConfig & config, const BenchmarkResults & results);
+
+#endif
@@ -0,0 +1,124 @@
+#include <math.h>
+#include <string.h>
+
+#include "bots.hpp"
+
+// Seconds the dodger looks ahead for an alien laser coming down on the player
+#define DODGE_LOOKAHEAD 1.0f
+
+// Horizontal distance under which a falling laser is considered a threat
+#define DODGE_MARGIN 2.5f
+
+
+//-------------------------------------------------------------------------------------------------
+void seedBot(BotState & state, unsigned int seed)
+{
+	// Same scrambling as the world, with another constant so the bot never mirrors the world's sequence
+	state.rngState = seed * 2246822519u + 0x85EBCA6Bu;
+	if (state.rngState == 0)
+	{
+		state.rngState = 1;
+	}
+	state.direction = 0;
+}
+
+// Next value of the bot's random sequence in [0, 1)
+static float botRandom01(BotState & state)
+{
+	state.rngState ^= state.rngState << 13;
+	state.rngState ^= state.rngState >> 17;
+	state.rngState ^= state.rngState << 5;
+	return static_cast<float>(state.rngState >> 8) / 16777216.0f;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Stands still and never fires, the baseline every other bot should beat
+static PlayerInput idleBot(const World &, BotState &)
+{
+	return PlayerInput();
+}
+
+// Wanders in random directions for random durations and fires whenever it can
+static PlayerInput randomBot(const World &, BotState & state)
+{
+	// About four direction changes per second at 60 steps per second
+	if (botRandom01(state) < 0.07f)
+	{
+		state.direction = static_cast<int>(botRandom01(state) * 3.0f) - 1;
+	}
+
+	PlayerInput input;
+	input.left = state.direction < 0;
+	input.right = state.direction > 0;
+	input.fire = true;
+	return input;
+}
+
+// Chases the lowest alien, see scriptedPlayerInput
+static PlayerInput chaserBot(const World & world, BotState &)
+{
+	return scriptedPlayerInput(world);
+}
+
+// Chases like the chaser, but steps aside from alien lasers about to reach the player
+static PlayerInput dodgerBot(const World & world, BotState &)
+{
+	PlayerInput input = scriptedPlayerInput(world);
+	const glm::vec3 & player = world.level->playerShip.position;
+
+	// Closest threat in time, lasers fall towards the player so only the ones above it matter
+	float threatX = 0.0f;
+	float threatTime = DODGE_LOOKAHEAD;
+	for (const Laser & laser : world.lasers)
+	{
+		if (!laser.active || laser.player_friendly || laser.direction.y >= 0.0f || laser.position.y < player.y)
+			continue;
+
+		float time = (laser.position.y - player.y) / (-laser.direction.y * laser.speed);
+		float x = laser.position.x + laser.direction.x * laser.speed * time; // Where it crosses the player's row
+		if (time < threatTime && fabs(x - player.x) < DODGE_MARGIN)
+		{
+			threatTime = time;
+			threatX = x;
+		}
+	}
+
+	if (threatTime < DODGE_LOOKAHEAD)
+	{
+		// Move away from the threat, unless that walks into a boundary
+		bool goLeft = threatX > player.x;
+		if (goLeft && player.x < LEFTBOUNDARY + DODGE_MARGIN)
+			goLeft = false;
+		else if (!goLeft && player.x > RIGHTBOUNDARY - DODGE_MARGIN)
+			goLeft = true;
+		input.left = goLeft;
+		input.right = !goLeft;
+	}
+
+	return input;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+const BotDefinition botDefinitions[] =
+{
+	{ "idle",   "never moves nor fires",                          idleBot },
+	{ "random", "moves at random and fires whenever it can",      randomBot },
+	{ "chaser", "chases the lowest alien and fires under it",     chaserBot },
+	{ "dodger", "chases like chaser and steps aside from lasers", dodgerBot }
+};
+
+const int BOT_COUNT = sizeof(botDefinitions) / sizeof(botDefinitions[0]);
+
+const BotDefinition * findBot(const char * name)
+{
+	for (int i = 0; i < BOT_COUNT; i++)
+	{
+		if (strcmp(botDefinitions[i].name, name) == 0)
+		{
+			return &botDefinitions[i];
+		}
+	}
+	return NULL;
+}
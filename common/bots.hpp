@@ -0,0 +1,34 @@
+#ifndef BOTS_HPP
+#define BOTS_HPP
+
+#include "world.hpp"
+
+// Private state of one bot, kept by whoever drives the world so a policy never touches the world's random sequence
+struct BotState
+{
+	unsigned int rngState = 1;   // xorshift32 state of the bot's own decisions
+	int direction = 0;           // Direction the bot keeps moving in (-1 left, 0 still, 1 right), used by the random bot
+};
+
+// A bot policy reads the world after a step and produces the controls of the next one
+typedef PlayerInput (*BotPolicy)(const World & world, BotState & state);
+
+// A policy selectable by name (e.g. on the command line)
+struct BotDefinition
+{
+	const char * name;
+	const char * description;
+	BotPolicy policy;
+};
+
+// Every built-in policy
+extern const BotDefinition botDefinitions[];
+extern const int BOT_COUNT;
+
+// Find a built-in policy by name, returns NULL if there is none
+const BotDefinition * findBot(const char * name);
+
+// Seed a bot's state, nearby seeds give unrelated decisions
+void seedBot(BotState & state, unsigned int seed);
+
+#endif
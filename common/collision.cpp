@@ -0,0 +1,97 @@
+#include <math.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "collision.hpp"
+
+Bounds computeBounds(const std::vector<glm::vec3> & vertices)
+{
+	Bounds bounds;
+	if (vertices.empty())
+		return bounds;
+
+	bounds.min = vertices[0];
+	bounds.max = vertices[0];
+	for (const glm::vec3 & vertex : vertices)
+	{
+		bounds.min = glm::min(bounds.min, vertex);
+		bounds.max = glm::max(bounds.max, vertex);
+	}
+
+	// Sphere around the box center, just large enough for the farthest vertex
+	bounds.center = (bounds.min + bounds.max) * 0.5f;
+	float radiusSquared = 0.0f;
+	for (const glm::vec3 & vertex : vertices)
+	{
+		glm::vec3 offset = vertex - bounds.center;
+		radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+	}
+	bounds.radius = sqrtf(radiusSquared);
+
+	return bounds;
+}
+
+Bounds scaleBounds(const Bounds & bounds, float scale)
+{
+	Bounds scaled;
+	scaled.min = bounds.min * scale;
+	scaled.max = bounds.max * scale;
+	scaled.center = bounds.center * scale;
+	scaled.radius = bounds.radius * scale;
+	return scaled;
+}
+
+Bounds rotateBoundsZ(const Bounds & bounds, float forwardX, float forwardY)
+{
+	// The rotation takes +X to (forwardY, -forwardX) and +Y to (forwardX, forwardY)
+	glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+	glm::vec3 halfSize = (bounds.max - bounds.min) * 0.5f;
+
+	// Box around the turned box: turned center, half sizes projected on each axis
+	glm::vec3 rotatedCenter(forwardY * center.x + forwardX * center.y, -forwardX * center.x + forwardY * center.y, center.z);
+	glm::vec3 rotatedHalfSize(fabsf(forwardY) * halfSize.x + fabsf(forwardX) * halfSize.y, fabsf(forwardX) * halfSize.x + fabsf(forwardY) * halfSize.y, halfSize.z);
+
+	Bounds rotated;
+	rotated.min = rotatedCenter - rotatedHalfSize;
+	rotated.max = rotatedCenter + rotatedHalfSize;
+	rotated.center = glm::vec3(forwardY * bounds.center.x + forwardX * bounds.center.y, -forwardX * bounds.center.x + forwardY * bounds.center.y, bounds.center.z);
+	rotated.radius = bounds.radius;
+	return rotated;
+}
+
+bool segmentAABBIntersect(const glm::vec3 & start, const glm::vec3 & end, const glm::vec3 & boxMin, const glm::vec3 & boxMax, float & t)
+{
+	glm::vec3 segment = end - start;
+	float tEnter = 0.0f;
+	float tExit = 1.0f;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (fabsf(segment[axis]) < 1e-8f)
+		{
+			// Segment parallel to this slab, it must already be inside it
+			if (start[axis] < boxMin[axis] || start[axis] > boxMax[axis])
+				return false;
+			continue;
+		}
+
+		float inverse = 1.0f / segment[axis];
+		float t1 = (boxMin[axis] - start[axis]) * inverse;
+		float t2 = (boxMax[axis] - start[axis]) * inverse;
+		if (t1 > t2)
+		{
+			float swap = t1;
+			t1 = t2;
+			t2 = swap;
+		}
+
+		tEnter = glm::max(tEnter, t1);
+		tExit = glm::min(tExit, t2);
+		if (tEnter > tExit)
+			return false;
+	}
+
+	t = tEnter;
+	return true;
+}
@@ -0,0 +1,30 @@
+#ifndef COLLISION_HPP
+#define COLLISION_HPP
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Bounding volumes of a mesh, relative to the mesh's origin
+struct Bounds
+{
+	glm::vec3 min = glm::vec3(0.0f);     // Minimum corner of the axis aligned bounding box
+	glm::vec3 max = glm::vec3(0.0f);     // Maximum corner of the axis aligned bounding box
+	glm::vec3 center = glm::vec3(0.0f);  // Center of the bounding sphere
+	float radius = 0.0f;                 // Radius of the bounding sphere
+};
+
+// Compute the bounding box and bounding sphere enclosing every vertex
+Bounds computeBounds(const std::vector<glm::vec3> & vertices);
+
+// Bounds of the same mesh drawn with a uniform scale
+Bounds scaleBounds(const Bounds & bounds, float scale);
+
+// Bounds of the same mesh turned around Z so that its +Y axis points along forward (a unit vector in the XY plane)
+Bounds rotateBoundsZ(const Bounds & bounds, float forwardX, float forwardY);
+
+// Swept test of the segment start->end against an axis aligned box (slab method).
+// On a hit, t receives the segment parameter where the segment enters the box.
+bool segmentAABBIntersect(const glm::vec3 & start, const glm::vec3 & end, const glm::vec3 & boxMin, const glm::vec3 & boxMax, float & t);
+
+#endif
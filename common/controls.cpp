@@ -2,6 +2,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "controls.hpp"
+#include "input.hpp"
 
 extern GLFWwindow *window;
 
@@ -67,33 +68,33 @@ void computeMatricesFromInput(glm::vec3 &playerPosition)
     glm::vec3 up = glm::cross(right, direction);
 
     // Camera movement (unchanged)
-    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+    if (isActionDown(ACTION_CAMERA_FORWARD))
     {
         position += direction * deltaTime * speed;
     }
-    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+    if (isActionDown(ACTION_CAMERA_BACK))
     {
         position -= direction * deltaTime * speed;
     }
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+    if (isActionDown(ACTION_CAMERA_RIGHT))
     {
         position += right * deltaTime * speed;
     }
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+    if (isActionDown(ACTION_CAMERA_LEFT))
     {
         position -= right * deltaTime * speed;
     }
 
-    // Check for camera mode switch keys
-    if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS)
+    // Check for camera mode switch keys, the mode changes when the key goes down
+    if (wasActionPressed(ACTION_CAMERA_1))
     {
         cameraMode = 1; // Player-Focused View
     }
-    if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS)
+    if (wasActionPressed(ACTION_CAMERA_2))
     {
         cameraMode = 2; // Static Position View
     }
-    if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS)
+    if (wasActionPressed(ACTION_CAMERA_3))
     {
         cameraMode = 3; // Free Camera Mode
     }
@@ -0,0 +1,89 @@
+#include <math.h>
+#include <stddef.h>
+
+#include <glm/glm.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULLING_SSE2 1
+#endif
+
+#include "culling.hpp"
+
+Frustum extractFrustum(const glm::mat4 & viewProjection)
+{
+	// Rows of the matrix (glm stores columns, so element [c][r] is column c, row r)
+	glm::vec4 row[4];
+	for (int r = 0; r < 4; r++)
+	{
+		row[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+	}
+
+	Frustum frustum;
+	frustum.planes[0] = row[3] + row[0]; // Left
+	frustum.planes[1] = row[3] - row[0]; // Right
+	frustum.planes[2] = row[3] + row[1]; // Bottom
+	frustum.planes[3] = row[3] - row[1]; // Top
+	frustum.planes[4] = row[3] + row[2]; // Near
+	frustum.planes[5] = row[3] - row[2]; // Far
+
+	// Normalize so the plane distance can be compared against sphere radii
+	for (glm::vec4 & plane : frustum.planes)
+	{
+		float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f)
+		{
+			plane = plane * (1.0f / length);
+		}
+	}
+
+	return frustum;
+}
+
+size_t cullSpheres(const Frustum & frustum, const float * x, const float * y, const float * z, const float * radius, size_t count, unsigned char * visible)
+{
+	size_t visibleCount = 0;
+	size_t i = 0;
+
+#ifdef CULLING_SSE2
+	// Four spheres per iteration against all six planes
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 px = _mm_loadu_ps(x + i);
+		__m128 py = _mm_loadu_ps(y + i);
+		__m128 pz = _mm_loadu_ps(z + i);
+		__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+		for (const glm::vec4 & plane : frustum.planes)
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(plane.x)), _mm_mul_ps(py, _mm_set1_ps(plane.y))),
+				_mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < 4; lane++)
+		{
+			visible[i + lane] = static_cast<unsigned char>((mask >> lane) & 1);
+			visibleCount += visible[i + lane];
+		}
+	}
+#endif
+
+	// Scalar path for the remaining spheres (or all of them without SSE2)
+	for (; i < count; i++)
+	{
+		unsigned char inside = 1;
+		for (const glm::vec4 & plane : frustum.planes)
+		{
+			float distance = plane.x * x[i] + plane.y * y[i] + plane.z * z[i] + plane.w;
+			inside &= static_cast<unsigned char>(distance >= -radius[i]);
+		}
+		visible[i] = inside;
+		visibleCount += inside;
+	}
+
+	return visibleCount;
+}
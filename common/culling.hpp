@@ -0,0 +1,22 @@
+#ifndef CULLING_HPP
+#define CULLING_HPP
+
+#include <stddef.h>
+
+#include <glm/glm.hpp>
+
+// The six planes of a view frustum, normalized so plane distances are in world units.
+// A point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+struct Frustum
+{
+	glm::vec4 planes[6];
+};
+
+// Extract the frustum planes from a combined projection * view matrix
+Frustum extractFrustum(const glm::mat4 & viewProjection);
+
+// Test a batch of bounding spheres stored as separate x, y, z and radius arrays.
+// visible[i] is set to 1 when sphere i touches the frustum and 0 otherwise, the number of visible spheres is returned.
+size_t cullSpheres(const Frustum & frustum, const float * x, const float * y, const float * z, const float * radius, size_t count, unsigned char * visible);
+
+#endif
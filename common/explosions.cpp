@@ -0,0 +1,156 @@
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "shader.hpp"
+#include "instancedmesh.hpp"
+#include "explosions.hpp"
+
+// Spawn time given to records that hold no explosion, far enough in the past to always be expired
+#define EXPLOSION_NEVER_SPAWNED -1000.0f
+
+InstancedMesh ExplosionMesh;
+GLBuffer ExplosionInstanceBuffer;   // MAX_EXPLOSIONS records of position (xyz) and spawn time (w)
+GLTexture ExplosionTexture;
+
+GLuint ExplosionShaderID = 0;
+GLint ExplosionVPID, ExplosionViewID, ExplosionTimeID, ExplosionLifetimeID, ExplosionSamplerID;
+
+// Spawn times are stored relative to the first spawn since the last clear, so they stay small enough for a float
+double ExplosionEpoch = 0.0;
+int ExplosionNext = 0;               // Record the next spawn writes, the oldest one once the ring is full
+int ExplosionUsed = 0;               // Records written since the last clear, at most MAX_EXPLOSIONS
+double ExplosionLastSpawn = -1.0e9;  // Nothing needs drawing once the newest explosion has expired
+
+bool initExplosions(const std::vector<glm::vec3> & vertices, const std::vector<glm::vec2> & uvs, const std::vector<glm::vec3> & normals, GLTexture texture)
+{
+	// Mesh attributes 0-2, the VAO stays bound for the instance record
+	if (!uploadInstancedMesh(ExplosionMesh, vertices, uvs, normals))
+	{
+		return false;
+	}
+
+	ExplosionTexture = std::move(texture);
+
+	// One record per explosion, advanced once per instance instead of once per vertex
+	ExplosionInstanceBuffer.create();
+	glBindBuffer(GL_ARRAY_BUFFER, ExplosionInstanceBuffer.get());
+	glBufferData(GL_ARRAY_BUFFER, MAX_EXPLOSIONS * sizeof(glm::vec4), NULL, GL_DYNAMIC_DRAW);
+	ExplosionInstanceBuffer.track(MEM_MESH_GPU, MAX_EXPLOSIONS * sizeof(glm::vec4));
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	glVertexAttribDivisor(3, 1);
+
+	glBindVertexArray(0);
+
+	ExplosionShaderID = LoadShaders("shaders/explosion.vertexshader", "shaders/main.fragmentshader");
+	ExplosionVPID = glGetUniformLocation(ExplosionShaderID, "VP");
+	ExplosionViewID = glGetUniformLocation(ExplosionShaderID, "V");
+	ExplosionTimeID = glGetUniformLocation(ExplosionShaderID, "Time");
+	ExplosionLifetimeID = glGetUniformLocation(ExplosionShaderID, "Lifetime");
+	ExplosionSamplerID = glGetUniformLocation(ExplosionShaderID, "myTextureSampler");
+
+	clearExplosions();
+	return true;
+}
+
+void spawnExplosion(const glm::vec3 & position, double time)
+{
+	spawnExplosions(&position, 1, time);
+}
+
+void spawnExplosions(const glm::vec3 * positions, int count, double time)
+{
+	if (!ExplosionInstanceBuffer || count <= 0)
+	{
+		return;
+	}
+
+	// The first explosion after a clear starts the epoch, the records before it are all unused
+	if (ExplosionUsed == 0)
+	{
+		ExplosionEpoch = time;
+	}
+
+	// More explosions than records would only overwrite each other, keep the last ones
+	if (count > MAX_EXPLOSIONS)
+	{
+		positions += count - MAX_EXPLOSIONS;
+		count = MAX_EXPLOSIONS;
+	}
+
+	glm::vec4 records[MAX_EXPLOSIONS];
+	for (int i = 0; i < count; i++)
+	{
+		records[i] = glm::vec4(positions[i], static_cast<float>(time - ExplosionEpoch));
+	}
+
+	// The records are contiguous in the ring unless they wrap around its end
+	int first = (count < MAX_EXPLOSIONS - ExplosionNext) ? count : MAX_EXPLOSIONS - ExplosionNext;
+	glBindBuffer(GL_ARRAY_BUFFER, ExplosionInstanceBuffer.get());
+	glBufferSubData(GL_ARRAY_BUFFER, ExplosionNext * sizeof(glm::vec4), first * sizeof(glm::vec4), &records[0]);
+	if (first < count)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, (count - first) * sizeof(glm::vec4), &records[first]);
+	}
+
+	ExplosionNext = (ExplosionNext + count) % MAX_EXPLOSIONS;
+	ExplosionUsed = (ExplosionUsed + count < MAX_EXPLOSIONS) ? ExplosionUsed + count : MAX_EXPLOSIONS;
+	ExplosionLastSpawn = time;
+}
+
+bool drawExplosions(const glm::mat4 & ProjectionMatrix, const glm::mat4 & ViewMatrix, double time)
+{
+	if (ExplosionShaderID == 0 || ExplosionUsed == 0 || time - ExplosionLastSpawn >= EXPLOSION_LIFETIME)
+	{
+		return false;
+	}
+
+	glm::mat4 VP = ProjectionMatrix * ViewMatrix;
+
+	glUseProgram(ExplosionShaderID);
+	glUniformMatrix4fv(ExplosionVPID, 1, GL_FALSE, &VP[0][0]);
+	glUniformMatrix4fv(ExplosionViewID, 1, GL_FALSE, &ViewMatrix[0][0]);
+	glUniform1f(ExplosionTimeID, static_cast<float>(time - ExplosionEpoch));
+	glUniform1f(ExplosionLifetimeID, EXPLOSION_LIFETIME);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, ExplosionTexture.get());
+	glUniform1i(ExplosionSamplerID, 0);
+
+	// Every written record is drawn, the shader discards the expired ones
+	glBindVertexArray(ExplosionMesh.vertexArray.get());
+	glDrawArraysInstanced(GL_TRIANGLES, 0, ExplosionMesh.vertexCount, ExplosionUsed);
+	glBindVertexArray(0);
+
+	return true;
+}
+
+void clearExplosions()
+{
+	if (!ExplosionInstanceBuffer)
+	{
+		return;
+	}
+
+	std::vector<glm::vec4> records(MAX_EXPLOSIONS, glm::vec4(0.0f, 0.0f, 0.0f, EXPLOSION_NEVER_SPAWNED));
+	glBindBuffer(GL_ARRAY_BUFFER, ExplosionInstanceBuffer.get());
+	glBufferSubData(GL_ARRAY_BUFFER, 0, records.size() * sizeof(glm::vec4), &records[0]);
+
+	ExplosionNext = 0;
+	ExplosionUsed = 0;
+	ExplosionLastSpawn = -1.0e9;
+}
+
+void cleanupExplosions()
+{
+	releaseInstancedMesh(ExplosionMesh);
+	ExplosionInstanceBuffer.reset();
+	ExplosionTexture.reset();
+	ExplosionUsed = 0;
+
+	glDeleteProgram(ExplosionShaderID);
+	ExplosionShaderID = 0;
+}
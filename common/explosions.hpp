@@ -0,0 +1,34 @@
+#ifndef EXPLOSIONS_HPP
+#define EXPLOSIONS_HPP
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "glhandles.hpp"
+
+// Explosions alive at once, spawning more overwrites the oldest one
+#define MAX_EXPLOSIONS 256
+
+// Seconds an explosion stays visible
+#define EXPLOSION_LIFETIME 0.5f
+
+// Upload the explosion mesh once and create the instance buffer, the texture is owned from now on
+bool initExplosions(const std::vector<glm::vec3> & vertices, const std::vector<glm::vec2> & uvs, const std::vector<glm::vec3> & normals, GLTexture texture);
+
+// Start an explosion: writes one instance record, the shader hides it again once it is EXPLOSION_LIFETIME old
+void spawnExplosion(const glm::vec3 & position, double time);
+
+// Start several explosions at once with at most two buffer uploads, only the last MAX_EXPLOSIONS are kept
+void spawnExplosions(const glm::vec3 * positions, int count, double time);
+
+// Draw every explosion with one instanced draw call, returns false if none was alive and nothing was drawn
+bool drawExplosions(const glm::mat4 & ProjectionMatrix, const glm::mat4 & ViewMatrix, double time);
+
+// Expire every explosion at once
+void clearExplosions();
+
+// Delete the mesh, the instance buffer, the texture and the shader
+void cleanupExplosions();
+
+#endif
@@ -0,0 +1,318 @@
+#include <stddef.h>
+
+#include <memory_resource>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FORMATION_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FORMATION_SSE2 1
+#endif
+
+#include "formation.hpp"
+
+AlienFormation::AlienFormation(std::pmr::memory_resource * memory)
+	: slotX(memory), slotY(memory), slotZ(memory), row(memory), col(memory), model(memory), id(memory), alive(memory),
+	columnAlive(memory), rowAlive(memory), columnX(memory), rowY(memory), cellAlive(memory), frontRow(memory)
+{
+}
+
+void AlienFormation::reserve(int rows, int columns)
+{
+	size_t count = static_cast<size_t>(rows) * columns;
+	slotX.reserve(count);
+	slotY.reserve(count);
+	slotZ.reserve(count);
+	row.reserve(count);
+	col.reserve(count);
+	model.reserve(count);
+	id.reserve(count);
+	alive.reserve(count);
+
+	columnAlive.assign(columns, 0);
+	rowAlive.assign(rows, 0);
+	columnX.assign(columns, 0.0f);
+	rowY.assign(rows, 0.0f);
+	cellAlive.assign(count, 0);
+	frontRow.assign(columns, -1);
+}
+
+void AlienFormation::add(const glm::vec3 & slot, int alienRow, int alienCol, int alienModel, int alienID)
+{
+	slotX.push_back(slot.x);
+	slotY.push_back(slot.y);
+	slotZ.push_back(slot.z);
+	row.push_back(alienRow);
+	col.push_back(alienCol);
+	model.push_back(alienModel);
+	id.push_back(alienID);
+	alive.push_back(1);
+
+	// Every alien of a column shares its x and every alien of a row its y
+	columnAlive[alienCol]++;
+	rowAlive[alienRow]++;
+	columnX[alienCol] = slot.x;
+	rowY[alienRow] = slot.y;
+	slotZ0 = slot.z;
+	cellAlive[alienRow * columns() + alienCol] = 1;
+	frontRow[alienCol] = (alienRow > frontRow[alienCol]) ? alienRow : frontRow[alienCol];
+
+	firstColumn = (firstColumn < 0 || alienCol < firstColumn) ? alienCol : firstColumn;
+	lastColumn = (alienCol > lastColumn) ? alienCol : lastColumn;
+	topRow = (topRow < 0 || alienRow < topRow) ? alienRow : topRow;
+	bottomRow = (alienRow > bottomRow) ? alienRow : bottomRow;
+}
+
+void AlienFormation::kill(size_t i)
+{
+	if (!alive[i])
+		return;
+
+	alive[i] = 0;
+	columnAlive[col[i]]--;
+	rowAlive[row[i]]--;
+	cellAlive[row[i] * columns() + col[i]] = 0;
+
+	// The next living alien up the column takes over its frontline, a column only ever walks up its rows once
+	int& front = frontRow[col[i]];
+	while (front >= 0 && !cellAlive[front * columns() + col[i]])
+		front--;
+
+	// The extents only ever move inwards, so over a level this costs one step per column and row
+	while (firstColumn >= 0 && firstColumn <= lastColumn && columnAlive[firstColumn] == 0)
+		firstColumn++;
+	while (lastColumn >= firstColumn && lastColumn >= 0 && columnAlive[lastColumn] == 0)
+		lastColumn--;
+	while (topRow >= 0 && topRow <= bottomRow && rowAlive[topRow] == 0)
+		topRow++;
+	while (bottomRow >= topRow && bottomRow >= 0 && rowAlive[bottomRow] == 0)
+		bottomRow--;
+
+	if (firstColumn > lastColumn || topRow > bottomRow)
+	{
+		firstColumn = lastColumn = topRow = bottomRow = -1;
+	}
+}
+
+bool AlienFormation::frontline(int column, glm::vec3 & position) const
+{
+	if (frontRow[column] < 0)
+		return false;
+	position = origin + glm::vec3(columnX[column], rowY[frontRow[column]], slotZ0);
+	return true;
+}
+
+bool AlienFormation::extentX(float & minX, float & maxX) const
+{
+	if (firstColumn < 0)
+		return false;
+	minX = origin.x + columnX[firstColumn];
+	maxX = origin.x + columnX[lastColumn];
+	return true;
+}
+
+bool AlienFormation::extentY(float & minY, float & maxY) const
+{
+	if (topRow < 0)
+		return false;
+	minY = origin.y + rowY[bottomRow];
+	maxY = origin.y + rowY[topRow];
+	return true;
+}
+
+void compactFormation(AlienFormation & formation)
+{
+	size_t i = 0;
+	while (i < formation.size())
+	{
+		if (formation.alive[i])
+		{
+			i++;
+			continue;
+		}
+
+		// Fill the hole with the last alien, the per-column and per-row counts were updated by kill
+		size_t last = formation.size() - 1;
+		formation.slotX[i] = formation.slotX[last];
+		formation.slotY[i] = formation.slotY[last];
+		formation.slotZ[i] = formation.slotZ[last];
+		formation.row[i] = formation.row[last];
+		formation.col[i] = formation.col[last];
+		formation.model[i] = formation.model[last];
+		formation.id[i] = formation.id[last];
+		formation.alive[i] = formation.alive[last];
+
+		formation.slotX.pop_back();
+		formation.slotY.pop_back();
+		formation.slotZ.pop_back();
+		formation.row.pop_back();
+		formation.col.pop_back();
+		formation.model.pop_back();
+		formation.id.pop_back();
+		formation.alive.pop_back();
+	}
+}
+
+bool stepFormation(AlienFormation & formation, bool movingRight, float speed, float dropDistance, float leftBoundary, float rightBoundary)
+{
+	float minX = 0.0f, maxX = 0.0f;
+	if (!formation.extentX(minX, maxX))
+		return movingRight;
+
+	// Only the outermost living column along the direction of movement can reach the boundary
+	if (movingRight ? maxX > rightBoundary : minX < leftBoundary)
+	{
+		movingRight = !movingRight;
+		formation.origin.y -= dropDistance;
+	}
+
+	formation.origin.x += movingRight ? speed : -speed;
+	return movingRight;
+}
+
+void offsetValuesScalar(float * values, size_t count, float offset)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		values[i] += offset;
+	}
+}
+
+void offsetValues(float * values, size_t count, float offset)
+{
+	size_t i = 0;
+
+#ifdef FORMATION_AVX
+	__m256 offset8 = _mm256_set1_ps(offset);
+	for (; i + 8 <= count; i += 8)
+	{
+		_mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), offset8));
+	}
+#endif
+
+#ifdef FORMATION_SSE2
+	__m128 offset4 = _mm_set1_ps(offset);
+	for (; i + 4 <= count; i += 4)
+	{
+		_mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), offset4));
+	}
+#endif
+
+	// Scalar path for the remaining values (or all of them without SIMD)
+	offsetValuesScalar(values + i, count - i, offset);
+}
+
+bool valueRangeScalar(const float * values, size_t count, float & minValue, float & maxValue)
+{
+	if (count == 0)
+		return false;
+
+	minValue = values[0];
+	maxValue = values[0];
+	for (size_t i = 1; i < count; i++)
+	{
+		minValue = values[i] < minValue ? values[i] : minValue;
+		maxValue = values[i] > maxValue ? values[i] : maxValue;
+	}
+	return true;
+}
+
+bool valueRange(const float * values, size_t count, float & minValue, float & maxValue)
+{
+	if (count == 0)
+		return false;
+
+	minValue = values[0];
+	maxValue = values[0];
+	size_t i = 0;
+
+#ifdef FORMATION_SSE2
+	if (count >= 4)
+	{
+		// Keep a running minimum and maximum per lane, then reduce the lanes once at the end
+		__m128 low = _mm_loadu_ps(values);
+		__m128 high = low;
+		i = 4;
+
+#ifdef FORMATION_AVX
+		if (count >= 16)
+		{
+			__m256 low8 = _mm256_loadu_ps(values);
+			__m256 high8 = low8;
+			for (i = 8; i + 8 <= count; i += 8)
+			{
+				__m256 v = _mm256_loadu_ps(values + i);
+				low8 = _mm256_min_ps(low8, v);
+				high8 = _mm256_max_ps(high8, v);
+			}
+			low = _mm_min_ps(_mm256_castps256_ps128(low8), _mm256_extractf128_ps(low8, 1));
+			high = _mm_max_ps(_mm256_castps256_ps128(high8), _mm256_extractf128_ps(high8, 1));
+		}
+#endif
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 v = _mm_loadu_ps(values + i);
+			low = _mm_min_ps(low, v);
+			high = _mm_max_ps(high, v);
+		}
+
+		// Fold four lanes into one: swap halves, then swap neighbours
+		low = _mm_min_ps(low, _mm_shuffle_ps(low, low, _MM_SHUFFLE(1, 0, 3, 2)));
+		low = _mm_min_ps(low, _mm_shuffle_ps(low, low, _MM_SHUFFLE(2, 3, 0, 1)));
+		high = _mm_max_ps(high, _mm_shuffle_ps(high, high, _MM_SHUFFLE(1, 0, 3, 2)));
+		high = _mm_max_ps(high, _mm_shuffle_ps(high, high, _MM_SHUFFLE(2, 3, 0, 1)));
+		minValue = _mm_cvtss_f32(low);
+		maxValue = _mm_cvtss_f32(high);
+	}
+#endif
+
+	// Scalar path for the remaining values (or all of them without SIMD)
+	for (; i < count; i++)
+	{
+		minValue = values[i] < minValue ? values[i] : minValue;
+		maxValue = values[i] > maxValue ? values[i] : maxValue;
+	}
+	return true;
+}
+
+const char * formationKernelName()
+{
+#if defined(FORMATION_AVX)
+	return "AVX";
+#elif defined(FORMATION_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+bool stepPositions(float * x, float * y, size_t count, bool movingRight, float speed, float dropDistance, float leftBoundary, float rightBoundary, bool simd)
+{
+	float minX = 0.0f, maxX = 0.0f;
+	bool found = simd ? valueRange(x, count, minX, maxX) : valueRangeScalar(x, count, minX, maxX);
+	if (!found)
+		return movingRight;
+
+	if (movingRight ? maxX > rightBoundary : minX < leftBoundary)
+	{
+		movingRight = !movingRight;
+		if (simd)
+			offsetValues(y, count, -dropDistance);
+		else
+			offsetValuesScalar(y, count, -dropDistance);
+	}
+
+	float step = movingRight ? speed : -speed;
+	if (simd)
+		offsetValues(x, count, step);
+	else
+		offsetValuesScalar(x, count, step);
+
+	return movingRight;
+}
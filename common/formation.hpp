@@ -0,0 +1,77 @@
+#ifndef FORMATION_HPP
+#define FORMATION_HPP
+
+#include <stddef.h>
+
+#include <memory_resource>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Aliens of a level as fixed grid slots relative to one formation origin, entry i of every per-alien array belongs to the same alien.
+// Moving the formation only moves the origin, and the extent of the living aliens is kept per column and row as they die,
+// so a tick of movement and its boundary check cost the same for any number of aliens.
+struct AlienFormation
+{
+	glm::vec3 origin = glm::vec3(0.0f);      // Offset of the whole formation, the only position that changes during the level
+
+	std::pmr::vector<float> slotX, slotY, slotZ; // Slot of each alien relative to origin (its spawn position), fixed for the level
+	std::pmr::vector<int> row, col;          // Grid row (0 = top) and column (0 = left) of each alien
+	std::pmr::vector<int> model;             // Alien model index (see AlienSpawn)
+	std::pmr::vector<int> id;                // Unique identifiers
+	std::pmr::vector<unsigned char> alive;   // Cleared by kill, dead aliens are removed at the end of the tick
+
+	std::pmr::vector<int> columnAlive, rowAlive; // Living aliens in each column and row
+	std::pmr::vector<float> columnX, rowY;   // Slot x of each column and slot y of each row
+	std::pmr::vector<unsigned char> cellAlive; // Whether the alien of each grid cell (row * columns + column) lives
+	std::pmr::vector<int> frontRow;          // Bottom-most living row of each column (its frontline alien), -1 once the column is empty
+	float slotZ0 = 0.0f;                     // Slot z shared by the whole grid
+	int firstColumn = -1, lastColumn = -1;   // Outermost columns and rows with a living alien, -1 when there is none
+	int topRow = -1, bottomRow = -1;
+
+	explicit AlienFormation(std::pmr::memory_resource * memory);
+
+	size_t size() const { return slotX.size(); }
+	bool empty() const { return slotX.empty(); }
+	glm::vec3 position(size_t i) const { return origin + glm::vec3(slotX[i], slotY[i], slotZ[i]); }
+
+	// Size the per-column and per-row tracking for a grid and room for every alien
+	void reserve(int rows, int columns);
+	void add(const glm::vec3 & slot, int row, int col, int model, int id);
+
+	// Mark an alien dead, shrink the extents if it was the last one of an outer column or row
+	// and move the column's frontline up if it was the column's frontline alien
+	void kill(size_t i);
+
+	// Number of grid columns and the world position of a column's frontline alien, false if the column is empty
+	int columns() const { return static_cast<int>(columnAlive.size()); }
+	bool frontline(int column, glm::vec3 & position) const;
+
+	// World x of the outermost living columns and world y of the outermost living rows, false if no alien lives
+	bool extentX(float & minX, float & maxX) const;
+	bool extentY(float & minY, float & maxY) const;
+};
+
+// Remove every dead alien in a single swap-and-pop pass, alien order is not preserved
+void compactFormation(AlienFormation & formation);
+
+// Advance the formation one tick: if it reached the boundary on the side it is moving to, reverse and drop
+// by dropDistance, then move sideways by speed. Returns whether it now moves right.
+bool stepFormation(AlienFormation & formation, bool movingRight, float speed, float dropDistance, float leftBoundary, float rightBoundary);
+
+// Add offset to count values. Uses AVX or SSE2 when the compiler targets them, the Scalar version never does.
+void offsetValues(float * values, size_t count, float offset);
+void offsetValuesScalar(float * values, size_t count, float offset);
+
+// Smallest and largest of count values as a vector reduction, returns false if count is 0
+bool valueRange(const float * values, size_t count, float & minValue, float & maxValue);
+bool valueRangeScalar(const float * values, size_t count, float & minValue, float & maxValue);
+
+// Instruction set the vector kernels were built for: "AVX", "SSE2" or "scalar"
+const char * formationKernelName();
+
+// The same tick as stepFormation for loose x and y arrays, every value is moved with the bulk kernels.
+// Kept for comparison in the formation benchmark, simd selects the vector kernels over the scalar ones.
+bool stepPositions(float * x, float * y, size_t count, bool movingRight, float speed, float dropDistance, float leftBoundary, float rightBoundary, bool simd);
+
+#endif
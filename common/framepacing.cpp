@@ -0,0 +1,109 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+#include "benchmark.hpp"
+#include "log.hpp"
+#include "framepacing.hpp"
+
+// Latency samples kept for the percentiles, the oldest ones are overwritten after that
+#define LATENCY_SAMPLES 4096
+
+static FramePacing activePacing;
+static double nextFrameStart = -1.0;        // When the next frame may start under the frame cap, negative before the first
+
+static std::vector<double> latencySamples;  // Ring of the latest input-to-present latencies in milliseconds
+static size_t latencyNext = 0;              // Sample overwritten next once the ring is full
+static double latencySum = 0.0;             // Of every sample ever recorded, for the mean
+static unsigned long latencyCount = 0;
+static double lastLatency = 0.0;
+
+
+//-------------------------------------------------------------------------------------------------
+void initFramePacing(const FramePacing & pacing, bool window)
+{
+	activePacing = pacing;
+	nextFrameStart = -1.0;
+	latencySamples.clear();
+	latencySamples.reserve(LATENCY_SAMPLES);
+	latencyNext = 0;
+	latencySum = 0.0;
+	latencyCount = 0;
+	lastLatency = 0.0;
+
+	if (window && pacing.swapInterval >= 0)
+	{
+		glfwSwapInterval(pacing.swapInterval);
+	}
+}
+
+void waitForFrameStart()
+{
+	if (activePacing.frameCap <= 0.0)
+		return;
+
+	double period = 1.0 / activePacing.frameCap;
+	double now = glfwGetTime();
+	if (nextFrameStart < 0.0 || now - nextFrameStart > period)
+	{
+		// First frame, or the loop fell behind: the cadence starts over from now
+		nextFrameStart = now + period;
+		return;
+	}
+
+	// Sleeping wakes up late by up to a scheduler tick, so it stops short and the rest is spun
+	double sleepTime = nextFrameStart - now - activePacing.spinMargin;
+	if (sleepTime > 0.0)
+	{
+		std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
+	}
+	while (glfwGetTime() < nextFrameStart)
+	{
+	}
+
+	nextFrameStart += period;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void recordFramePresented(double inputTime)
+{
+	if (inputTime < 0.0)
+		return;
+
+	double latency = (glfwGetTime() - inputTime) * 1000.0;
+	if (latencySamples.size() < LATENCY_SAMPLES)
+	{
+		latencySamples.push_back(latency);
+	}
+	else
+	{
+		latencySamples[latencyNext] = latency;
+		latencyNext = (latencyNext + 1) % LATENCY_SAMPLES;
+	}
+	latencySum += latency;
+	latencyCount++;
+	lastLatency = latency;
+}
+
+double getLastInputLatency()
+{
+	return lastLatency;
+}
+
+double getMeanInputLatency()
+{
+	return latencyCount > 0 ? latencySum / latencyCount : 0.0;
+}
+
+void reportInputLatency()
+{
+	if (latencySamples.empty())
+		return;
+
+	LOG_INFO("Input to present latency (%s, swap interval %d, cap %.0f fps) over %lu presses: mean %.2f ms p50 %.2f ms p95 %.2f ms max %.2f ms",
+		activePacing.lowLatency ? "low latency" : "default", activePacing.swapInterval, activePacing.frameCap, latencyCount,
+		getMeanInputLatency(), percentile(latencySamples, 0.50), percentile(latencySamples, 0.95), percentile(latencySamples, 1.0));
+}
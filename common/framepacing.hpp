@@ -0,0 +1,31 @@
+#ifndef FRAMEPACING_HPP
+#define FRAMEPACING_HPP
+
+// How the main loop paces its frames, given on the command line
+struct FramePacing
+{
+	bool lowLatency = false;    // Read input right before the simulation and wait for the GPU after presenting (--low-latency)
+	int swapInterval = -1;      // Vertical blanks per buffer swap, 0 = no vsync, -1 = the driver's default (--swap-interval)
+	double frameCap = 0.0;      // Frames per second the loop is held to, 0 = uncapped (--fps-cap)
+	double spinMargin = 0.002;  // Seconds before the frame's start the wait stops sleeping and spins, covers late wakeups
+};
+
+// Apply the swap interval to the current context, only meaningful for a visible window
+void initFramePacing(const FramePacing & pacing, bool window);
+
+// Wait until the next frame may start under the frame cap: sleep most of the time, spin the rest.
+// A loop that fell more than a frame behind starts a new cadence instead of rushing to catch up.
+void waitForFrameStart();
+
+// Record that a frame was presented now, inputTime is when the oldest key press it shows happened (negative if none).
+// The latency is measured to when presenting returned, in low-latency mode that is after the GPU finished the frame.
+void recordFramePresented(double inputTime);
+
+// Latest and mean input-to-present latency in milliseconds, 0 before the first key press was presented
+double getLastInputLatency();
+double getMeanInputLatency();
+
+// Log the percentiles of the input-to-present latency measured so far
+void reportInputLatency();
+
+#endif
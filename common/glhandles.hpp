@@ -0,0 +1,98 @@
+#ifndef GLHANDLES_HPP
+#define GLHANDLES_HPP
+
+#include <GL/glew.h>
+
+#include "memstats.hpp"
+
+// How each kind of OpenGL object is created and deleted
+struct GLBufferTraits
+{
+	static GLuint create() { GLuint name = 0; glGenBuffers(1, &name); return name; }
+	static void destroy(GLuint name) { glDeleteBuffers(1, &name); }
+};
+
+struct GLVertexArrayTraits
+{
+	static GLuint create() { GLuint name = 0; glGenVertexArrays(1, &name); return name; }
+	static void destroy(GLuint name) { glDeleteVertexArrays(1, &name); }
+};
+
+struct GLTextureTraits
+{
+	static GLuint create() { GLuint name = 0; glGenTextures(1, &name); return name; }
+	static void destroy(GLuint name) { glDeleteTextures(1, &name); }
+};
+
+// Owner of a single OpenGL object name. The object is deleted when the handle is destroyed or reset.
+// Handles can be moved but not copied, so every object has exactly one owner and is deleted exactly once.
+// The GL context must still exist when a non-empty handle is destroyed.
+// A handle can account the memory of its object (see track), the bytes are released together with the object.
+template <typename Traits>
+class GLHandle
+{
+public:
+	GLHandle() : name(0), trackedCategory(MEM_MESH_GPU), trackedBytes(0) {}
+	explicit GLHandle(GLuint adopted) : name(adopted), trackedCategory(MEM_MESH_GPU), trackedBytes(0) {}   // Take ownership of an existing object
+	~GLHandle() { reset(); }
+
+	GLHandle(const GLHandle &) = delete;
+	GLHandle & operator=(const GLHandle &) = delete;
+
+	GLHandle(GLHandle && other) noexcept
+		: name(other.name), trackedCategory(other.trackedCategory), trackedBytes(other.trackedBytes)
+	{
+		other.name = 0;
+		other.trackedBytes = 0;
+	}
+	GLHandle & operator=(GLHandle && other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			name = other.name;
+			trackedCategory = other.trackedCategory;
+			trackedBytes = other.trackedBytes;
+			other.name = 0;
+			other.trackedBytes = 0;
+		}
+		return *this;
+	}
+
+	// Delete the current object (if any) and create a new one
+	void create() { reset(); name = Traits::create(); }
+
+	// Delete the object, the handle becomes empty
+	void reset()
+	{
+		if (name)
+		{
+			Traits::destroy(name);
+			name = 0;
+		}
+		track(trackedCategory, 0);
+	}
+
+	// Account the object's storage (e.g. after glBufferData) under a category, replacing the previous amount
+	void track(MemCategory category, size_t bytes)
+	{
+		memRemove(trackedCategory, trackedBytes);
+		trackedCategory = category;
+		trackedBytes = bytes;
+		memAdd(trackedCategory, trackedBytes);
+	}
+
+	GLuint get() const { return name; }
+	explicit operator bool() const { return name != 0; }
+
+private:
+	GLuint name;
+	MemCategory trackedCategory;
+	size_t trackedBytes;
+};
+
+typedef GLHandle<GLBufferTraits> GLBuffer;
+typedef GLHandle<GLVertexArrayTraits> GLVertexArray;
+typedef GLHandle<GLTextureTraits> GLTexture;
+
+#endif
@@ -0,0 +1,96 @@
+#include <GL/glew.h>
+
+#include "gputimer.hpp"
+
+// Frames of queries kept in flight. endGpuFrame at the end of frame N reads the slot issued in frame
+// N - (GPU_TIMER_FRAMES - 1), one frame back with two slots. A result the GPU has not finished yet is left
+// pending and its slot skipped until it is, so reading never waits.
+#define GPU_TIMER_FRAMES 2
+
+const char * const gpuPassNames[GPU_PASS_COUNT] = { "OPAQUE", "EXPLOSIONS", "TEXT" };
+
+GLuint GpuTimerQueryIDs[GPU_TIMER_FRAMES][GPU_PASS_COUNT];
+bool GpuTimerPending[GPU_TIMER_FRAMES][GPU_PASS_COUNT]; // Query issued and its result not read yet
+bool GpuTimerIssued[GPU_PASS_COUNT];                     // Pass already timed in the current frame
+double GpuPassTimes[GPU_PASS_COUNT];                     // Latest results in milliseconds
+int GpuTimerFrame = 0;                                   // Ring slot used by the current frame
+bool GpuTimersReady = false;
+
+void initGpuTimers()
+{
+	glGenQueries(GPU_TIMER_FRAMES * GPU_PASS_COUNT, &GpuTimerQueryIDs[0][0]);
+	for (int frame = 0; frame < GPU_TIMER_FRAMES; frame++)
+	{
+		for (int pass = 0; pass < GPU_PASS_COUNT; pass++)
+		{
+			GpuTimerPending[frame][pass] = false;
+		}
+	}
+	for (int pass = 0; pass < GPU_PASS_COUNT; pass++)
+	{
+		GpuTimerIssued[pass] = false;
+		GpuPassTimes[pass] = 0.0;
+	}
+	GpuTimerFrame = 0;
+	GpuTimersReady = true;
+}
+
+void beginGpuPass(GpuPass pass)
+{
+	// Skip if the slot's previous query has not been read yet, reusing it would stall
+	if (!GpuTimersReady || GpuTimerIssued[pass] || GpuTimerPending[GpuTimerFrame][pass])
+		return;
+
+	glBeginQuery(GL_TIME_ELAPSED, GpuTimerQueryIDs[GpuTimerFrame][pass]);
+	GpuTimerIssued[pass] = true;
+	GpuTimerPending[GpuTimerFrame][pass] = true;
+}
+
+void endGpuPass(GpuPass pass)
+{
+	if (!GpuTimersReady || !GpuTimerIssued[pass])
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+}
+
+void endGpuFrame()
+{
+	if (!GpuTimersReady)
+		return;
+
+	// Move to the oldest slot and collect whatever of it the GPU has finished
+	GpuTimerFrame = (GpuTimerFrame + 1) % GPU_TIMER_FRAMES;
+	for (int pass = 0; pass < GPU_PASS_COUNT; pass++)
+	{
+		GpuTimerIssued[pass] = false;
+
+		if (!GpuTimerPending[GpuTimerFrame][pass])
+			continue;
+
+		GLuint query = GpuTimerQueryIDs[GpuTimerFrame][pass];
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available)
+		{
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+			GpuPassTimes[pass] = static_cast<double>(nanoseconds) / 1000000.0;
+			GpuTimerPending[GpuTimerFrame][pass] = false;
+		}
+	}
+}
+
+double getGpuPassTime(GpuPass pass)
+{
+	return GpuPassTimes[pass];
+}
+
+void cleanupGpuTimers()
+{
+	if (!GpuTimersReady)
+		return;
+
+	glDeleteQueries(GPU_TIMER_FRAMES * GPU_PASS_COUNT, &GpuTimerQueryIDs[0][0]);
+	GpuTimersReady = false;
+}
@@ -0,0 +1,32 @@
+#ifndef GPUTIMER_HPP
+#define GPUTIMER_HPP
+
+// Render passes measured with GL_TIME_ELAPSED queries
+enum GpuPass
+{
+	GPU_PASS_OPAQUE,      // Player, mothership, aliens, shields and lasers
+	GPU_PASS_EXPLOSIONS,  // Explosions
+	GPU_PASS_TEXT,        // Text2D
+	GPU_PASS_COUNT
+};
+
+// Names of the passes for the overlay and log
+extern const char * const gpuPassNames[GPU_PASS_COUNT];
+
+// Create the query objects
+void initGpuTimers();
+
+// Start and stop timing a pass, each pass is timed at most once per frame and passes must not overlap
+void beginGpuPass(GpuPass pass);
+void endGpuPass(GpuPass pass);
+
+// Finish the frame: results of older frames are collected only once the GPU has them ready, so this never stalls
+void endGpuFrame();
+
+// Latest GPU time of a pass in milliseconds
+double getGpuPassTime(GpuPass pass);
+
+// Delete the query objects
+void cleanupGpuTimers();
+
+#endif
@@ -0,0 +1,35 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "imagecompare.hpp"
+
+ImageDifference compareImages(const unsigned char * image, const unsigned char * reference, int width, int height, int channels, int pixelTolerance)
+{
+	ImageDifference result;
+	double squaredSum = 0.0;
+	long long differingPixels = 0;
+	long long pixelCount = static_cast<long long>(width) * height;
+
+	for (long long pixel = 0; pixel < pixelCount; pixel++)
+	{
+		bool differs = false;
+		for (int channel = 0; channel < channels; channel++)
+		{
+			int difference = abs(static_cast<int>(image[pixel * channels + channel]) - static_cast<int>(reference[pixel * channels + channel]));
+			squaredSum += static_cast<double>(difference) * difference;
+			if (difference > result.maxDifference)
+				result.maxDifference = difference;
+			if (difference > pixelTolerance)
+				differs = true;
+		}
+		if (differs)
+			differingPixels++;
+	}
+
+	if (pixelCount > 0)
+	{
+		result.rmse = sqrt(squaredSum / (static_cast<double>(pixelCount) * channels));
+		result.differingFraction = static_cast<double>(differingPixels) / pixelCount;
+	}
+	return result;
+}
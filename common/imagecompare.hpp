@@ -0,0 +1,16 @@
+#ifndef IMAGECOMPARE_HPP
+#define IMAGECOMPARE_HPP
+
+// Result of comparing a rendered image against a reference image
+struct ImageDifference
+{
+	double rmse = 0.0;               // Root mean square error over all channels (0..255)
+	int maxDifference = 0;           // Largest difference of any single channel
+	double differingFraction = 0.0;  // Fraction of pixels with a channel differing by more than the pixel tolerance
+};
+
+// Compare two images of the same size and channel count.
+// A pixel counts as differing when any of its channels differs by more than pixelTolerance.
+ImageDifference compareImages(const unsigned char * image, const unsigned char * reference, int width, int height, int channels, int pixelTolerance);
+
+#endif
@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+#include "input.hpp"
+
+// Events the queue holds before it has to grow, far more than a frame ever brings
+#define INPUT_QUEUE_RESERVE 64
+
+// Action bound to each GLFW key, -1 if none
+static int keyActions[GLFW_KEY_LAST + 1];
+
+// Events queued by the key callback since the last update, the callback runs inside glfwPollEvents on the main thread
+static std::vector<InputEvent> eventQueue;
+
+static int keysDown[ACTION_COUNT];         // Keys of each action held down
+static bool pressedEdge[ACTION_COUNT];     // Each action went down during the last update
+static double oldestPress = -1.0;          // Time of the earliest key press applied by the last update, negative if none
+
+static GLFWwindow * inputWindow = NULL;
+static unsigned long updateNumber = 0;     // Updates so far, recordings are indexed by it
+
+static FILE * recordFile = NULL;
+static std::vector<unsigned long> replayUpdates; // Update each replayed event is applied in
+static std::vector<InputEvent> replayEvents;
+static size_t replayNext = 0;              // Next replayed event to apply
+static std::vector<unsigned long> replayStepUpdates; // Update each replayed time step belongs to
+static std::vector<float> replaySteps;
+static size_t replayStepNext = 0;          // Next replayed time step
+static bool replaying = false;
+
+
+//-------------------------------------------------------------------------------------------------
+static void keyCallback(GLFWwindow *, int key, int, int action, int)
+{
+	// Held keys repeat, only the transitions matter
+	if (key < 0 || key > GLFW_KEY_LAST || keyActions[key] < 0 || action == GLFW_REPEAT)
+		return;
+
+	InputEvent event;
+	event.time = glfwGetTime();
+	event.action = keyActions[key];
+	event.pressed = (action == GLFW_PRESS);
+	eventQueue.push_back(event);
+}
+
+void initInput(GLFWwindow * window)
+{
+	for (int key = 0; key <= GLFW_KEY_LAST; key++)
+	{
+		keyActions[key] = -1;
+	}
+	for (int action = 0; action < ACTION_COUNT; action++)
+	{
+		keysDown[action] = 0;
+		pressedEdge[action] = false;
+	}
+	eventQueue.clear();
+	eventQueue.reserve(INPUT_QUEUE_RESERVE);
+
+	bindKey(GLFW_KEY_A, ACTION_MOVE_LEFT);
+	bindKey(GLFW_KEY_D, ACTION_MOVE_RIGHT);
+	bindKey(GLFW_KEY_SPACE, ACTION_FIRE);
+	bindKey(GLFW_KEY_P, ACTION_PAUSE);
+	bindKey(GLFW_KEY_ENTER, ACTION_CONFIRM);
+	bindKey(GLFW_KEY_KP_ENTER, ACTION_CONFIRM);
+	bindKey(GLFW_KEY_R, ACTION_RESTART);
+	bindKey(GLFW_KEY_K, ACTION_SKIP_LEVEL);
+	bindKey(GLFW_KEY_F3, ACTION_TOGGLE_STATS);
+	bindKey(GLFW_KEY_ESCAPE, ACTION_QUIT);
+	bindKey(GLFW_KEY_UP, ACTION_CAMERA_FORWARD);
+	bindKey(GLFW_KEY_DOWN, ACTION_CAMERA_BACK);
+	bindKey(GLFW_KEY_RIGHT, ACTION_CAMERA_RIGHT);
+	bindKey(GLFW_KEY_LEFT, ACTION_CAMERA_LEFT);
+	bindKey(GLFW_KEY_1, ACTION_CAMERA_1);
+	bindKey(GLFW_KEY_2, ACTION_CAMERA_2);
+	bindKey(GLFW_KEY_3, ACTION_CAMERA_3);
+
+	inputWindow = window;
+	glfwSetKeyCallback(window, keyCallback);
+}
+
+void bindKey(int key, InputAction action)
+{
+	if (key >= 0 && key <= GLFW_KEY_LAST)
+	{
+		keyActions[key] = action;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to apply one event to the held keys and edges of its action
+static void applyEvent(const InputEvent & event)
+{
+	if (event.action < 0 || event.action >= ACTION_COUNT)
+		return;
+
+	if (event.pressed)
+	{
+		// An action is down while any of its keys is, it only goes down with the first one
+		if (keysDown[event.action]++ == 0)
+		{
+			pressedEdge[event.action] = true;
+		}
+	}
+	else if (keysDown[event.action] > 0)
+	{
+		keysDown[event.action]--;
+	}
+
+	if (recordFile)
+	{
+		fprintf(recordFile, "%lu %.6f %d %d\n", updateNumber, event.time, event.action, event.pressed ? 1 : 0);
+	}
+}
+
+void updateInput()
+{
+	for (int action = 0; action < ACTION_COUNT; action++)
+	{
+		pressedEdge[action] = false;
+	}
+
+	// The events are applied in the order they happened, a press and release within one frame still leave their edge
+	oldestPress = -1.0;
+	for (const InputEvent & event : eventQueue)
+	{
+		if (!replaying || event.action == ACTION_QUIT)
+		{
+			applyEvent(event);
+			if (event.pressed && (oldestPress < 0.0 || event.time < oldestPress))
+			{
+				oldestPress = event.time;
+			}
+		}
+	}
+	eventQueue.clear();
+
+	while (replaying && replayNext < replayEvents.size() && replayUpdates[replayNext] <= updateNumber)
+	{
+		applyEvent(replayEvents[replayNext]);
+		replayNext++;
+	}
+	replaying = replaying && (replayNext < replayEvents.size() || replayStepNext < replaySteps.size());
+
+	updateNumber++;
+}
+
+float inputTimeStep(float deltaTime)
+{
+	if (replaying)
+	{
+		// Steps of updates that did not step this time are skipped, the replay has already gone its own way then
+		while (replayStepNext < replaySteps.size() && replayStepUpdates[replayStepNext] < updateNumber)
+		{
+			replayStepNext++;
+		}
+		if (replayStepNext < replaySteps.size() && replayStepUpdates[replayStepNext] == updateNumber)
+		{
+			deltaTime = replaySteps[replayStepNext++];
+		}
+		replaying = replayNext < replayEvents.size() || replayStepNext < replaySteps.size();
+	}
+	else if (recordFile)
+	{
+		// Enough digits to read back the exact same float
+		fprintf(recordFile, "step %lu %.9g\n", updateNumber, deltaTime);
+	}
+	return deltaTime;
+}
+
+bool isActionDown(InputAction action)
+{
+	return keysDown[action] > 0;
+}
+
+bool wasActionPressed(InputAction action)
+{
+	return pressedEdge[action];
+}
+
+double getOldestInputPress()
+{
+	return oldestPress;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+bool startInputRecording(const char * path)
+{
+	if (recordFile)
+	{
+		fclose(recordFile);
+	}
+
+	recordFile = fopen(path, "w");
+	if (!recordFile)
+	{
+		printf("Impossible to open input recording %s\n", path);
+		return false;
+	}
+
+	// Updates are counted from the start of the recording, so replays start in step with it
+	fprintf(recordFile, "# update time action pressed, or step update deltaTime\n");
+	updateNumber = 0;
+	return true;
+}
+
+bool startInputReplay(const char * path)
+{
+	FILE * file = fopen(path, "r");
+	if (!file)
+	{
+		printf("Impossible to open input recording %s\n", path);
+		return false;
+	}
+
+	replayUpdates.clear();
+	replayEvents.clear();
+	replayStepUpdates.clear();
+	replaySteps.clear();
+	char line[256];
+	while (fgets(line, sizeof(line), file))
+	{
+		unsigned long update;
+		InputEvent event;
+		int pressed;
+		float step;
+		if (line[0] == '#')
+			continue;
+		if (sscanf(line, "step %lu %f", &update, &step) == 2)
+		{
+			replayStepUpdates.push_back(update);
+			replaySteps.push_back(step);
+			continue;
+		}
+		if (sscanf(line, "%lu %lf %d %d", &update, &event.time, &event.action, &pressed) != 4 || event.action < 0 || event.action >= ACTION_COUNT)
+		{
+			printf("Invalid input recording %s: %s", path, line);
+			fclose(file);
+			replayEvents.clear();
+			replaySteps.clear();
+			return false;
+		}
+		event.pressed = (pressed != 0);
+		replayUpdates.push_back(update);
+		replayEvents.push_back(event);
+	}
+	fclose(file);
+
+	updateNumber = 0;
+	replayNext = 0;
+	replayStepNext = 0;
+	replaying = !replayEvents.empty() || !replaySteps.empty();
+	return true;
+}
+
+bool isReplayingInput()
+{
+	return replaying;
+}
+
+void cleanupInput()
+{
+	if (recordFile)
+	{
+		fclose(recordFile);
+		recordFile = NULL;
+	}
+	if (inputWindow)
+	{
+		glfwSetKeyCallback(inputWindow, NULL);
+		inputWindow = NULL;
+	}
+	replaying = false;
+}
@@ -0,0 +1,73 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <GLFW/glfw3.h>
+
+// Everything the player can do with the keyboard, keys are bound to actions and the game only asks about actions
+enum InputAction
+{
+	ACTION_MOVE_LEFT,
+	ACTION_MOVE_RIGHT,
+	ACTION_FIRE,
+	ACTION_PAUSE,           // Pause and unpause
+	ACTION_CONFIRM,         // Start the game, start the next level
+	ACTION_RESTART,         // Play again after a game over
+	ACTION_SKIP_LEVEL,      // Win the level at once (debug)
+	ACTION_TOGGLE_STATS,    // Statistics overlay
+	ACTION_QUIT,
+	ACTION_CAMERA_FORWARD,  // Free camera movement
+	ACTION_CAMERA_BACK,
+	ACTION_CAMERA_RIGHT,
+	ACTION_CAMERA_LEFT,
+	ACTION_CAMERA_1,        // Camera modes
+	ACTION_CAMERA_2,
+	ACTION_CAMERA_3,
+	ACTION_COUNT
+};
+
+// A key of an action going down or up
+struct InputEvent
+{
+	double time;            // When GLFW reported it (glfwGetTime)
+	int action;             // InputAction
+	bool pressed;           // Went down (true) or up (false)
+};
+
+// Install the key callback on the window and bind the default keys, the callback only queues events
+void initInput(GLFWwindow * window);
+
+// Bind a GLFW key to an action, several keys may share one action
+void bindKey(int key, InputAction action);
+
+// Apply the events queued since the last call, once per frame after glfwPollEvents.
+// The pressed and released edges seen by the functions below are the ones of these events.
+void updateInput();
+
+// Whether a key of the action is held down
+bool isActionDown(InputAction action);
+
+// Whether the action went down during the last update, even if it was released again before the update
+bool wasActionPressed(InputAction action);
+
+// When the earliest key press applied by the last update happened (glfwGetTime), negative if there was none.
+// Replayed events are not counted, their times belong to the recorded session.
+double getOldestInputPress();
+
+// Time step of the simulation step about to run on the input of the last update: written to the recording,
+// or replaced by the recorded one while a replay runs, so a replay with the same seed plays the same game
+float inputTimeStep(float deltaTime);
+
+// Write every event applied from now on to a file, with the update it was applied in, and every time step
+bool startInputRecording(const char * path);
+
+// Apply the events of a recording instead of the keyboard's, each in the update it was recorded in.
+// Only the quit action is still taken from the keyboard while a replay runs.
+bool startInputReplay(const char * path);
+
+// Whether a replay has events or time steps left
+bool isReplayingInput();
+
+// Close the recording, if any, and remove the key callback
+void cleanupInput();
+
+#endif
@@ -0,0 +1,53 @@
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "instancedmesh.hpp"
+
+bool uploadInstancedMesh(InstancedMesh & mesh, const std::vector<glm::vec3> & vertices, const std::vector<glm::vec2> & uvs, const std::vector<glm::vec3> & normals)
+{
+	if (vertices.empty() || uvs.size() != vertices.size() || normals.size() != vertices.size())
+	{
+		return false;
+	}
+
+	mesh.vertexCount = static_cast<GLsizei>(vertices.size());
+
+	// The attribute layout never changes, so it is recorded in the VAO once
+	mesh.vertexArray.create();
+	glBindVertexArray(mesh.vertexArray.get());
+
+	mesh.vertexBuffer.create();
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer.get());
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), &vertices[0], GL_STATIC_DRAW);
+	mesh.vertexBuffer.track(MEM_MESH_GPU, vertices.size() * sizeof(glm::vec3));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+	mesh.uvBuffer.create();
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.uvBuffer.get());
+	glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(glm::vec2), &uvs[0], GL_STATIC_DRAW);
+	mesh.uvBuffer.track(MEM_MESH_GPU, uvs.size() * sizeof(glm::vec2));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+	mesh.normalBuffer.create();
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.normalBuffer.get());
+	glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), &normals[0], GL_STATIC_DRAW);
+	mesh.normalBuffer.track(MEM_MESH_GPU, normals.size() * sizeof(glm::vec3));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+	return true;
+}
+
+void releaseInstancedMesh(InstancedMesh & mesh)
+{
+	mesh.vertexArray.reset();
+	mesh.vertexBuffer.reset();
+	mesh.uvBuffer.reset();
+	mesh.normalBuffer.reset();
+	mesh.vertexCount = 0;
+}
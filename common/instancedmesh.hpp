@@ -0,0 +1,28 @@
+#ifndef INSTANCEDMESH_HPP
+#define INSTANCEDMESH_HPP
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "glhandles.hpp"
+
+// A static mesh drawn many times with one instanced draw call. Attributes 0-2 (position, uv, normal)
+// come from the mesh, the module drawing it adds its own per-instance attributes from 3 on.
+struct InstancedMesh
+{
+	GLVertexArray vertexArray;
+	GLBuffer vertexBuffer;
+	GLBuffer uvBuffer;
+	GLBuffer normalBuffer;
+	GLsizei vertexCount = 0;
+};
+
+// Upload the mesh and record attributes 0-2 in a new VAO, which is left bound for the instance attributes.
+// Returns false without creating anything if the arrays are empty or of different lengths.
+bool uploadInstancedMesh(InstancedMesh & mesh, const std::vector<glm::vec3> & vertices, const std::vector<glm::vec2> & uvs, const std::vector<glm::vec3> & normals);
+
+// Delete the VAO and the mesh buffers
+void releaseInstancedMesh(InstancedMesh & mesh);
+
+#endif
@@ -0,0 +1,102 @@
+#include <stddef.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "shader.hpp"
+#include "instancedmesh.hpp"
+#include "laserbatch.hpp"
+
+// Records the instance buffer starts with
+#define LASER_BATCH_INITIAL_CAPACITY 256
+
+InstancedMesh LaserBatchMesh;
+GLBuffer LaserBatchInstanceBuffer;
+GLTexture LaserBatchTexture;
+size_t LaserBatchCapacity = 0;       // Records the instance buffer holds
+
+GLuint LaserBatchShaderID = 0;
+GLint LaserBatchVPID, LaserBatchViewID, LaserBatchSamplerID;
+
+bool initLaserBatch(const std::vector<glm::vec3> & vertices, const std::vector<glm::vec2> & uvs, const std::vector<glm::vec3> & normals, GLTexture texture)
+{
+	// Mesh attributes 0-2, the VAO stays bound for the instance attributes
+	if (!uploadInstancedMesh(LaserBatchMesh, vertices, uvs, normals))
+	{
+		return false;
+	}
+
+	LaserBatchTexture = std::move(texture);
+
+	// Position and direction of each laser, advanced once per instance instead of once per vertex
+	LaserBatchCapacity = LASER_BATCH_INITIAL_CAPACITY;
+	LaserBatchInstanceBuffer.create();
+	glBindBuffer(GL_ARRAY_BUFFER, LaserBatchInstanceBuffer.get());
+	glBufferData(GL_ARRAY_BUFFER, LaserBatchCapacity * sizeof(LaserInstance), NULL, GL_STREAM_DRAW);
+	LaserBatchInstanceBuffer.track(MEM_MESH_GPU, LaserBatchCapacity * sizeof(LaserInstance));
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(LaserInstance), (void*)offsetof(LaserInstance, position));
+	glVertexAttribDivisor(3, 1);
+	glEnableVertexAttribArray(4);
+	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(LaserInstance), (void*)offsetof(LaserInstance, direction));
+	glVertexAttribDivisor(4, 1);
+
+	glBindVertexArray(0);
+
+	LaserBatchShaderID = LoadShaders("shaders/laser.vertexshader", "shaders/main.fragmentshader");
+	LaserBatchVPID = glGetUniformLocation(LaserBatchShaderID, "VP");
+	LaserBatchViewID = glGetUniformLocation(LaserBatchShaderID, "V");
+	LaserBatchSamplerID = glGetUniformLocation(LaserBatchShaderID, "myTextureSampler");
+
+	return true;
+}
+
+bool drawLaserBatch(const std::vector<LaserInstance> & instances, const glm::mat4 & ProjectionMatrix, const glm::mat4 & ViewMatrix)
+{
+	if (LaserBatchShaderID == 0 || instances.empty())
+	{
+		return false;
+	}
+
+	// Grow to the next power of two that fits, so a burst of lasers only reallocates a few times
+	while (LaserBatchCapacity < instances.size())
+	{
+		LaserBatchCapacity *= 2;
+	}
+
+	// Orphan the buffer before refilling it: the driver hands out fresh storage instead of
+	// waiting for the draws of earlier frames that still read the old contents
+	glBindBuffer(GL_ARRAY_BUFFER, LaserBatchInstanceBuffer.get());
+	glBufferData(GL_ARRAY_BUFFER, LaserBatchCapacity * sizeof(LaserInstance), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(LaserInstance), &instances[0]);
+	LaserBatchInstanceBuffer.track(MEM_MESH_GPU, LaserBatchCapacity * sizeof(LaserInstance));
+
+	glm::mat4 VP = ProjectionMatrix * ViewMatrix;
+
+	glUseProgram(LaserBatchShaderID);
+	glUniformMatrix4fv(LaserBatchVPID, 1, GL_FALSE, &VP[0][0]);
+	glUniformMatrix4fv(LaserBatchViewID, 1, GL_FALSE, &ViewMatrix[0][0]);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, LaserBatchTexture.get());
+	glUniform1i(LaserBatchSamplerID, 0);
+
+	glBindVertexArray(LaserBatchMesh.vertexArray.get());
+	glDrawArraysInstanced(GL_TRIANGLES, 0, LaserBatchMesh.vertexCount, static_cast<GLsizei>(instances.size()));
+	glBindVertexArray(0);
+
+	return true;
+}
+
+void cleanupLaserBatch()
+{
+	releaseInstancedMesh(LaserBatchMesh);
+	LaserBatchInstanceBuffer.reset();
+	LaserBatchTexture.reset();
+	LaserBatchCapacity = 0;
+
+	glDeleteProgram(LaserBatchShaderID);
+	LaserBatchShaderID = 0;
+}
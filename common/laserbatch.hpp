@@ -0,0 +1,27 @@
+#ifndef LASERBATCH_HPP
+#define LASERBATCH_HPP
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "glhandles.hpp"
+
+// What the laser shader needs of one laser, one record per active laser
+struct LaserInstance
+{
+	glm::vec3 position;   // World position
+	glm::vec3 direction;  // Unit direction the laser moves in, the model is turned to point along it
+};
+
+// Upload the laser mesh once and create the instance buffer, the texture is owned from now on
+bool initLaserBatch(const std::vector<glm::vec3> & vertices, const std::vector<glm::vec2> & uvs, const std::vector<glm::vec3> & normals, GLTexture texture);
+
+// Draw every laser with one instanced draw call, returns false if there was nothing to draw.
+// The instance buffer is orphaned and refilled on every call, it grows to the most lasers ever drawn.
+bool drawLaserBatch(const std::vector<LaserInstance> & instances, const glm::mat4 & ProjectionMatrix, const glm::mat4 & ViewMatrix);
+
+// Delete the mesh, the instance buffer, the texture and the shader
+void cleanupLaserBatch();
+
+#endif
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include <glm/glm.hpp>
+
+#include "levelfile.hpp"
+
+float classicAlienFireInterval(int rows, int cols)
+{
+	// Every alien rolled 1 in 150000 once per living alien each frame, so a full formation of n aliens
+	// fired n * n / 150000 times a frame, about n * n / 2500 times a second at 60 frames per second
+	float aliens = static_cast<float>(rows * cols);
+	float shotsPerSecond = aliens * aliens / 2500.0f;
+	return cols / shotsPerSecond;
+}
+
+bool validateLevel(const LevelDefinition & level, std::string & error)
+{
+	std::ostringstream msg;
+
+	if (level.rowAliens < 1 || level.rowAliens > MAX_LEVEL_ROWS)
+		msg << "rows must be between 1 and " << MAX_LEVEL_ROWS;
+	else if (level.colAliens < 1 || level.colAliens > MAX_LEVEL_COLS)
+		msg << "cols must be between 1 and " << MAX_LEVEL_COLS;
+	else if (level.alienSpacing <= 0.0f)
+		msg << "grid spacing must be positive";
+	else if ((level.colAliens - 1) * level.alienSpacing > RIGHTBOUNDARY - LEFTBOUNDARY)
+		msg << "a formation of " << level.colAliens << " columns " << level.alienSpacing << " apart is wider than the playfield";
+	else if (level.alienStart.y < -35.0f || level.alienStart.y > 35.0f)
+		msg << "grid start y " << level.alienStart.y << " is outside the play area";
+	else if (level.shieldHealth < 1)
+		msg << "shield health must be at least 1";
+	else if (level.playerHealth < 1)
+		msg << "player health must be at least 1";
+	else if (level.alienSpeed <= 0.0f || level.alienSpeed > 1.0f)
+		msg << "alien speed must be in (0, 1]";
+	else if (level.alienFireInterval <= 0.0f)
+		msg << "alien fire interval must be positive";
+	else if (level.motherShipHealth < 1)
+		msg << "mothership health must be at least 1";
+	else if (level.shieldPositions.size() > MAX_LEVEL_SHIELDS)
+		msg << "at most " << MAX_LEVEL_SHIELDS << " shields are allowed";
+	else
+	{
+		for (const glm::vec3 & shield : level.shieldPositions)
+		{
+			// Shields outside the area lasers can reach would never be hit
+			if (shield.x < -55.0f || shield.x > 55.0f || shield.y < -35.0f || shield.y > 35.0f)
+			{
+				msg << "shield at (" << shield.x << ", " << shield.y << ") is outside the play area";
+				break;
+			}
+		}
+	}
+
+	error = msg.str();
+	return error.empty();
+}
+
+void buildSpawnTable(LevelDefinition & level)
+{
+	level.spawnTable.clear();
+	level.spawnTable.reserve(level.rowAliens * level.colAliens);
+
+	for (int row = 0; row < level.rowAliens; ++row)
+	{
+		for (int col = 0; col < level.colAliens; ++col)
+		{
+			AlienSpawn spawn;
+			spawn.position = level.alienStart + glm::vec3(col * level.alienSpacing, -row * level.alienSpacing, 0.0f);
+			spawn.row = row;
+			spawn.col = col;
+			spawn.model = row % ALIEN_MODEL_COUNT;
+			level.spawnTable.push_back(spawn);
+		}
+	}
+}
+
+void makeDefaultLevels(std::vector<LevelDefinition> & out_levels, int count)
+{
+	out_levels.clear();
+
+	// Same progression the game used before levels were data-driven
+	for (int number = 1; number <= count; ++number)
+	{
+		LevelDefinition level;
+		level.rowAliens = 3 + number;
+		level.colAliens = 3 + number;
+		level.shieldHealth = 10 + (number * 5);
+		level.playerHealth = 3;
+		level.alienSpeed = 0.01f + (number * 0.01f);
+		level.alienFireInterval = classicAlienFireInterval(level.rowAliens, level.colAliens);
+		level.motherShipHealth = 5 + (number * 5);
+		level.shieldPositions.push_back(glm::vec3(-30.0f, -20.0f, 0.0f));
+		level.shieldPositions.push_back(glm::vec3(0.0f, -20.0f, 0.0f));
+		level.shieldPositions.push_back(glm::vec3(30.0f, -20.0f, 0.0f));
+		buildSpawnTable(level);
+		out_levels.push_back(level);
+	}
+}
+
+bool loadLevelFile(const char * path, std::vector<LevelDefinition> & out_levels)
+{
+	std::ifstream file(path, std::ios::in);
+	if (!file.is_open())
+	{
+		printf("Impossible to open level file %s\n", path);
+		return false;
+	}
+
+	std::vector<LevelDefinition> levels;
+	std::string line;
+	int lineNumber = 0;
+
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+
+		std::istringstream in(line);
+		std::string keyword;
+		if (!(in >> keyword) || keyword[0] == '#')
+			continue; // Skip blank lines and comments
+
+		bool ok = true;
+		if (keyword == "level")
+		{
+			LevelDefinition level;
+			ok = static_cast<bool>(in >> level.rowAliens >> level.colAliens >> level.shieldHealth
+				>> level.playerHealth >> level.alienSpeed >> level.motherShipHealth);
+			level.alienFireInterval = classicAlienFireInterval(level.rowAliens, level.colAliens); // Until a fire line says otherwise
+			levels.push_back(level);
+		}
+		else if (levels.empty())
+		{
+			printf("%s:%d: '%s' before the first level\n", path, lineNumber, keyword.c_str());
+			return false;
+		}
+		else if (keyword == "grid")
+		{
+			LevelDefinition & level = levels.back();
+			ok = static_cast<bool>(in >> level.alienSpacing >> level.alienStart.x >> level.alienStart.y);
+		}
+		else if (keyword == "fire")
+		{
+			ok = static_cast<bool>(in >> levels.back().alienFireInterval);
+		}
+		else if (keyword == "shield")
+		{
+			glm::vec3 position(0.0f, 0.0f, 0.0f);
+			ok = static_cast<bool>(in >> position.x >> position.y);
+			levels.back().shieldPositions.push_back(position);
+		}
+		else
+		{
+			printf("%s:%d: unknown keyword '%s'\n", path, lineNumber, keyword.c_str());
+			return false;
+		}
+
+		if (!ok)
+		{
+			printf("%s:%d: malformed '%s' line\n", path, lineNumber, keyword.c_str());
+			return false;
+		}
+	}
+
+	if (levels.empty())
+	{
+		printf("%s: no levels defined\n", path);
+		return false;
+	}
+
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		std::string error;
+		if (!validateLevel(levels[i], error))
+		{
+			printf("%s: level %d: %s\n", path, static_cast<int>(i + 1), error.c_str());
+			return false;
+		}
+		buildSpawnTable(levels[i]);
+	}
+
+	out_levels.swap(levels);
+	return true;
+}
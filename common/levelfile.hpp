@@ -0,0 +1,61 @@
+#ifndef LEVELFILE_HPP
+#define LEVELFILE_HPP
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Number of alien models the spawn table cycles through (one per row)
+#define ALIEN_MODEL_COUNT 3
+
+// Horizontal boundaries of the movement area, a level's formation must fit between them
+const float LEFTBOUNDARY = -50.0f;
+const float RIGHTBOUNDARY = 50.0f;
+
+// Limits enforced by the level validator
+#define MAX_LEVEL_ROWS 16
+#define MAX_LEVEL_COLS 16
+#define MAX_LEVEL_SHIELDS 8
+
+// One precomputed alien spawn slot of a level
+struct AlienSpawn
+{
+	glm::vec3 position;  // Position of the alien when the level starts
+	int row;             // Grid row (0 = top row)
+	int col;             // Grid column (0 = left column)
+	int model;           // Alien model index, cycles through the alien models by row
+};
+
+// Description of a single level as loaded from the level file
+struct LevelDefinition
+{
+	int rowAliens = 0;
+	int colAliens = 0;
+	float alienSpacing = 5.0f;
+	glm::vec3 alienStart = glm::vec3(0.0f, 25.0f, 0.0f);
+	int shieldHealth = 0;
+	int playerHealth = 0;
+	float alienSpeed = 0.0f;
+	float alienFireInterval = 5.0f;      // Average seconds between two shots of one formation column
+	int motherShipHealth = 0;
+	std::vector<glm::vec3> shieldPositions;
+	std::vector<AlienSpawn> spawnTable;  // Filled by buildSpawnTable, never recomputed afterwards
+};
+
+// Parse, validate and precompute every level described in a level file
+bool loadLevelFile(const char * path, std::vector<LevelDefinition> & out_levels);
+
+// Built-in levels used when the level file is missing or invalid
+void makeDefaultLevels(std::vector<LevelDefinition> & out_levels, int count);
+
+// Column fire interval at which a full rows x cols formation fires as often as the old per-alien roll did
+float classicAlienFireInterval(int rows, int cols);
+
+// Check a level for values the game cannot play, error describes the first problem found
+bool validateLevel(const LevelDefinition & level, std::string & error);
+
+// Precompute the alien spawn positions of a level
+void buildSpawnTable(LevelDefinition & level);
+
+#endif
@@ -0,0 +1,152 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "log.hpp"
+
+// Number of messages the ring holds (a power of two) and the longest message kept, longer ones are truncated
+#define LOG_RING_SIZE 1024
+#define LOG_MESSAGE_SIZE 256
+
+// How long the writer thread sleeps when the ring is empty
+#define LOG_IDLE_SLEEP_MS 2
+
+// One message of the ring.
+// Slot i is free for the producer claiming position p when sequence == p - i, it holds a finished
+// message for the consumer when sequence == p - i + 1. Relative sequences let the ring start zeroed.
+struct LogSlot
+{
+	std::atomic<size_t> sequence;
+	int level;
+	char text[LOG_MESSAGE_SIZE];
+};
+
+static LogSlot ring[LOG_RING_SIZE];
+static std::atomic<size_t> enqueuePosition(0);  // Next position claimed by a producer
+static size_t dequeuePosition = 0;              // Next position read by the writer, only touched by one thread at a time
+static std::atomic<unsigned int> droppedMessages(0);
+static std::atomic<int> minimumLevel(LOG_LEVEL_TRACE); // Messages below it are ignored, see setLogLevel
+
+static std::mutex controlMutex;                 // Serializes startLog and stopLog, never taken by logWrite
+static std::atomic<bool> running(false);
+static std::thread writer;
+
+static const size_t RING_MASK = LOG_RING_SIZE - 1;
+
+void logWrite(int level, const char * format, ...)
+{
+	if (level < minimumLevel.load(std::memory_order_relaxed))
+		return;
+
+	// Claim a slot
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	LogSlot * slot;
+	for (;;)
+	{
+		slot = &ring[position & RING_MASK];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position & ~RING_MASK);
+		if (difference == 0)
+		{
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			// The writer has not caught up, dropping is better than stalling the caller
+			droppedMessages.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+		{
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Format straight into the slot and publish it
+	va_list args;
+	va_start(args, format);
+	vsnprintf(slot->text, LOG_MESSAGE_SIZE, format, args);
+	va_end(args);
+	slot->level = level;
+	slot->sequence.store((position & ~RING_MASK) + 1, std::memory_order_release);
+}
+
+// Write every published message, returns the number written
+static int drainRing()
+{
+	int written = 0;
+	for (;;)
+	{
+		LogSlot & slot = ring[dequeuePosition & RING_MASK];
+		if (slot.sequence.load(std::memory_order_acquire) != (dequeuePosition & ~RING_MASK) + 1)
+			break; // Empty, or the next message is still being formatted
+
+		fprintf(slot.level >= LOG_LEVEL_WARN ? stderr : stdout, "%s\n", slot.text);
+		slot.sequence.store((dequeuePosition & ~RING_MASK) + LOG_RING_SIZE, std::memory_order_release);
+		dequeuePosition++;
+		written++;
+	}
+	return written;
+}
+
+static void writerLoop()
+{
+	while (running.load(std::memory_order_acquire))
+	{
+		if (drainRing() > 0)
+		{
+			fflush(stdout); // Flushing happens here, never on the threads that log
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(LOG_IDLE_SLEEP_MS));
+		}
+	}
+}
+
+void startLog()
+{
+	std::lock_guard<std::mutex> lock(controlMutex);
+	if (running.load())
+		return;
+	running.store(true, std::memory_order_release);
+	writer = std::thread(writerLoop);
+}
+
+void stopLog()
+{
+	std::lock_guard<std::mutex> lock(controlMutex);
+	if (running.exchange(false))
+	{
+		writer.join();
+	}
+
+	drainRing();
+	unsigned int dropped = droppedMessages.exchange(0);
+	if (dropped > 0)
+	{
+		fprintf(stderr, "%u log messages dropped\n", dropped);
+	}
+	fflush(stdout);
+}
+
+unsigned int getLogDropped()
+{
+	return droppedMessages.load(std::memory_order_relaxed);
+}
+
+void setLogLevel(int level)
+{
+	minimumLevel.store(level, std::memory_order_relaxed);
+}
+
+// Writes whatever is still queued when the program exits, even if stopLog was never called
+static struct LogShutdown
+{
+	~LogShutdown() { stopLog(); }
+} logShutdown;
@@ -0,0 +1,75 @@
+#ifndef LOG_HPP
+#define LOG_HPP
+
+// Severity levels of log messages
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_WARN  3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_NONE  5
+
+// Messages below this level are removed at compile time, arguments included.
+// Release builds (NDEBUG) keep info and above, other builds keep debug and above.
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#ifdef __GNUC__
+#define LOG_PRINTF_FORMAT __attribute__((format(printf, 2, 3)))
+#else
+#define LOG_PRINTF_FORMAT
+#endif
+
+// Format a message into the lock-free log ring, safe to call from any thread.
+// Never blocks and never touches the console: a background thread writes the message later.
+// When the ring is full the message is dropped and counted (see getLogDropped).
+void logWrite(int level, const char * format, ...) LOG_PRINTF_FORMAT;
+
+// Start the background thread writing queued messages to stdout (stderr for warnings and errors)
+void startLog();
+
+// Write every message still queued and stop the thread, also done automatically at exit
+void stopLog();
+
+// Number of messages dropped because the ring was full
+unsigned int getLogDropped();
+
+// Ignore messages below level from now on, on top of LOG_MIN_LEVEL (e.g. to silence per-game debug output of batch runs)
+void setLogLevel(int level);
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(...) logWrite(LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logWrite(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) logWrite(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) logWrite(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logWrite(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+#include "log.hpp"
+#include "memstats.hpp"
+
+const char * const memCategoryNames[MEM_CATEGORY_COUNT] = { "mesh cpu", "mesh gpu", "textures", "text", "entities" };
+
+static size_t currentBytes[MEM_CATEGORY_COUNT];
+static size_t peakBytes[MEM_CATEGORY_COUNT];
+
+void memAdd(MemCategory category, size_t bytes)
+{
+	currentBytes[category] += bytes;
+	if (currentBytes[category] > peakBytes[category])
+		peakBytes[category] = currentBytes[category];
+}
+
+void memRemove(MemCategory category, size_t bytes)
+{
+	// Never wrap around, an unbalanced release would otherwise show up as a huge leak
+	currentBytes[category] -= (bytes < currentBytes[category]) ? bytes : currentBytes[category];
+}
+
+size_t memCurrent(MemCategory category)
+{
+	return currentBytes[category];
+}
+
+size_t memPeak(MemCategory category)
+{
+	return peakBytes[category];
+}
+
+size_t memTotal()
+{
+	size_t total = 0;
+	for (int i = 0; i < MEM_CATEGORY_COUNT; i++)
+		total += currentBytes[i];
+	return total;
+}
+
+void printMemStats(const char * label)
+{
+	LOG_INFO("Memory %s", label);
+	for (int i = 0; i < MEM_CATEGORY_COUNT; i++)
+	{
+		LOG_INFO("  %-10s %10.1f KB  peak %10.1f KB", memCategoryNames[i],
+			currentBytes[i] / 1024.0, peakBytes[i] / 1024.0);
+	}
+	LOG_INFO("  %-10s %10.1f KB", "total", memTotal() / 1024.0);
+}
+
+CountingMemoryResource::CountingMemoryResource(MemCategory category, std::pmr::memory_resource * upstream)
+	: category(category), upstream(upstream)
+{
+}
+
+void * CountingMemoryResource::do_allocate(size_t bytes, size_t alignment)
+{
+	void * p = upstream->allocate(bytes, alignment);
+	memAdd(category, bytes);
+	return p;
+}
+
+void CountingMemoryResource::do_deallocate(void * p, size_t bytes, size_t alignment)
+{
+	upstream->deallocate(p, bytes, alignment);
+	memRemove(category, bytes);
+}
+
+bool CountingMemoryResource::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+{
+	return this == &other;
+}
@@ -0,0 +1,51 @@
+#ifndef MEMSTATS_HPP
+#define MEMSTATS_HPP
+
+#include <stddef.h>
+
+#include <memory_resource>
+
+// Categories memory is accounted under
+enum MemCategory
+{
+	MEM_MESH_CPU,      // Vertex data kept in the OBJ cache
+	MEM_MESH_GPU,      // Vertex buffers of the game objects
+	MEM_TEXTURES,      // Model and font textures, mipmaps included
+	MEM_TEXT_BUFFERS,  // Vertex buffers of the text renderer
+	MEM_ENTITIES,      // Level arenas: entity containers and per-entity data
+	MEM_CATEGORY_COUNT
+};
+
+// Short names of the categories for the overlay and the dumps
+extern const char * const memCategoryNames[MEM_CATEGORY_COUNT];
+
+// Account bytes allocated or released in a category
+void memAdd(MemCategory category, size_t bytes);
+void memRemove(MemCategory category, size_t bytes);
+
+// Bytes currently held and the most ever held at once in a category
+size_t memCurrent(MemCategory category);
+size_t memPeak(MemCategory category);
+
+// Bytes currently held over all categories
+size_t memTotal();
+
+// Log the current and peak bytes of every category, label says when the dump was taken
+void printMemStats(const char * label);
+
+// Memory resource that accounts everything it hands out under one category, allocations go to upstream
+class CountingMemoryResource : public std::pmr::memory_resource
+{
+public:
+	explicit CountingMemoryResource(MemCategory category, std::pmr::memory_resource * upstream = std::pmr::new_delete_resource());
+
+private:
+	void * do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void * p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+
+	MemCategory category;
+	std::pmr::memory_resource * upstream;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "pngwrite.hpp"
+
+// Minimal PNG encoder. The image data is stored in uncompressed deflate blocks,
+// which keeps the writer tiny while any PNG reader (including stb_image) can load it.
+
+static unsigned int crcTable[256];
+static bool crcTableReady = false;
+
+static unsigned int crc32(const unsigned char * data, size_t length, unsigned int crc)
+{
+	if (!crcTableReady)
+	{
+		for (unsigned int n = 0; n < 256; n++)
+		{
+			unsigned int c = n;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			crcTable[n] = c;
+		}
+		crcTableReady = true;
+	}
+
+	crc = ~crc;
+	for (size_t i = 0; i < length; i++)
+		crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+static void putBigEndian(std::vector<unsigned char> & out, unsigned int value)
+{
+	out.push_back(static_cast<unsigned char>(value >> 24));
+	out.push_back(static_cast<unsigned char>(value >> 16));
+	out.push_back(static_cast<unsigned char>(value >> 8));
+	out.push_back(static_cast<unsigned char>(value));
+}
+
+static void writeChunk(FILE * file, const char * type, const std::vector<unsigned char> & data)
+{
+	std::vector<unsigned char> chunk;
+	putBigEndian(chunk, static_cast<unsigned int>(data.size()));
+	chunk.insert(chunk.end(), type, type + 4);
+	chunk.insert(chunk.end(), data.begin(), data.end());
+	putBigEndian(chunk, crc32(&chunk[4], chunk.size() - 4, 0));
+	fwrite(&chunk[0], 1, chunk.size(), file);
+}
+
+bool writePNG(const char * path, int width, int height, int channels, const unsigned char * pixels, bool flipVertically)
+{
+	if (width <= 0 || height <= 0 || (channels != 3 && channels != 4))
+		return false;
+
+	FILE * file = fopen(path, "wb");
+	if (!file)
+	{
+		printf("%s could not be opened for writing\n", path);
+		return false;
+	}
+
+	// Raw scanlines, each prefixed with filter type 0 (none)
+	size_t rowSize = static_cast<size_t>(width) * channels;
+	std::vector<unsigned char> raw;
+	raw.reserve((rowSize + 1) * height);
+	for (int y = 0; y < height; y++)
+	{
+		int sourceRow = flipVertically ? height - 1 - y : y;
+		raw.push_back(0);
+		raw.insert(raw.end(), pixels + sourceRow * rowSize, pixels + (sourceRow + 1) * rowSize);
+	}
+
+	// zlib stream made of stored deflate blocks of at most 65535 bytes
+	std::vector<unsigned char> zlib;
+	zlib.push_back(0x78);
+	zlib.push_back(0x01);
+	size_t offset = 0;
+	do
+	{
+		size_t blockSize = raw.size() - offset;
+		if (blockSize > 65535)
+			blockSize = 65535;
+		bool last = offset + blockSize == raw.size();
+
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back(static_cast<unsigned char>(blockSize & 0xFF));
+		zlib.push_back(static_cast<unsigned char>(blockSize >> 8));
+		zlib.push_back(static_cast<unsigned char>(~blockSize & 0xFF));
+		zlib.push_back(static_cast<unsigned char>((~blockSize >> 8) & 0xFF));
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+		offset += blockSize;
+	} while (offset < raw.size());
+
+	unsigned int a = 1, b = 0;
+	for (unsigned char byte : raw)
+	{
+		a = (a + byte) % 65521;
+		b = (b + a) % 65521;
+	}
+	putBigEndian(zlib, (b << 16) | a);
+
+	// Header: size, 8 bits per channel, RGB (2) or RGBA (6), no interlacing
+	std::vector<unsigned char> header;
+	putBigEndian(header, static_cast<unsigned int>(width));
+	putBigEndian(header, static_cast<unsigned int>(height));
+	header.push_back(8);
+	header.push_back(channels == 4 ? 6 : 2);
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	fwrite(signature, 1, sizeof(signature), file);
+	writeChunk(file, "IHDR", header);
+	writeChunk(file, "IDAT", zlib);
+	writeChunk(file, "IEND", std::vector<unsigned char>());
+
+	bool ok = ferror(file) == 0;
+	fclose(file);
+	return ok;
+}
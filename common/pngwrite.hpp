@@ -0,0 +1,8 @@
+#ifndef PNGWRITE_HPP
+#define PNGWRITE_HPP
+
+// Write 8-bit RGB (channels = 3) or RGBA (channels = 4) pixels to a PNG file.
+// Rows are expected top to bottom unless flipVertically is set (as returned by glReadPixels).
+bool writePNG(const char * path, int width, int height, int channels, const unsigned char * pixels, bool flipVertically);
+
+#endif
@@ -0,0 +1,513 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "snapshot.hpp"
+
+// First bytes of every snapshot ("SIWS" read as a little-endian word)
+#define SNAPSHOT_MAGIC 0x53574953u
+
+// Every record and array starts at a multiple of this, so it can also be read in place
+#define SNAPSHOT_ALIGNMENT 8
+
+// Level index of a snapshot taken while no level was loaded
+#define SNAPSHOT_NO_LEVEL 0xFFFFFFFFu
+
+
+// Sizes of everything that follows, checked against the world's definitions before anything is restored
+struct SnapshotHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int size;             // Bytes of the whole snapshot
+	unsigned int definitionCount;  // Level definitions of the world the snapshot was taken from
+	unsigned int levelIndex;       // Definition of the current level, SNAPSHOT_NO_LEVEL if none
+	unsigned int rows, columns;    // Grid of the level's formation
+	unsigned int alienCount;       // Living aliens
+	unsigned int shieldCount;
+	unsigned int laserCount;
+	unsigned int explosionCount;
+	unsigned int padding;
+};
+
+// An entity without its bounds, which follow from its model and scale
+struct SnapshotEntity
+{
+	float position[3];
+	float scale;
+	int model;
+	int kind;
+	int id;
+	unsigned char alive;
+	unsigned char padding[3];
+};
+
+// Every scalar of the world and of its level
+struct SnapshotState
+{
+	double time;
+	double lastShotTime;
+	double lastHitTime;
+	double nextBlinkTime;
+	unsigned int rngState;
+	int nextObjectId;
+	int levelNumber;
+	int state;
+	int playerPoints;
+	int highScore;
+	int mothershipHealth;
+	unsigned char alienMovingRight;
+	unsigned char mothershipAlive;
+	unsigned char mothershipMovingRight;
+	unsigned char isInvincible;
+	unsigned char isBlinking;
+	unsigned char padding[3];
+
+	// Level
+	SnapshotEntity playerShip;
+	SnapshotEntity motherShip;
+	int playerHealth;
+	float alienSpeed;
+	float origin[3];               // Formation origin
+	float slotZ0;
+	int firstColumn, lastColumn, topRow, bottomRow;
+	unsigned int levelPadding;
+};
+
+struct SnapshotShield
+{
+	SnapshotEntity obj;
+	int health;
+	unsigned int padding;
+};
+
+// A laser without its bounds and kind, which follow from its direction and side
+struct SnapshotLaser
+{
+	float position[3];
+	float previousPosition[3];
+	float direction[3];
+	float speed;
+	int id;
+	unsigned char active;
+	unsigned char playerFriendly;
+	unsigned char padding[2];
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to append a block of bytes to the snapshot, padded with zeros up to the next alignment boundary
+static void appendBytes(std::vector<unsigned char> & snapshot, const void * values, size_t bytes)
+{
+	const unsigned char * first = static_cast<const unsigned char *>(values);
+	snapshot.insert(snapshot.end(), first, first + bytes);
+	snapshot.resize((snapshot.size() + SNAPSHOT_ALIGNMENT - 1) & ~static_cast<size_t>(SNAPSHOT_ALIGNMENT - 1), 0);
+}
+
+template <typename Array>
+static void appendArray(std::vector<unsigned char> & snapshot, const Array & values)
+{
+	appendBytes(snapshot, values.data(), values.size() * sizeof(values[0]));
+}
+
+static void saveEntity(SnapshotEntity & record, const Entity & entity)
+{
+	record.position[0] = entity.position.x;
+	record.position[1] = entity.position.y;
+	record.position[2] = entity.position.z;
+	record.scale = entity.scale;
+	record.model = entity.model;
+	record.kind = entity.kind;
+	record.id = entity.id;
+	record.alive = entity.alive;
+}
+
+void saveSnapshot(const World & world, std::vector<unsigned char> & snapshot)
+{
+	snapshot.clear();
+
+	const Level * level = world.level;
+	SnapshotHeader header = {};
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.definitionCount = static_cast<unsigned int>(world.definitions.size());
+	header.levelIndex = SNAPSHOT_NO_LEVEL;
+	if (level)
+	{
+		header.levelIndex = static_cast<unsigned int>(&level->definition - &world.definitions[0]);
+		header.rows = static_cast<unsigned int>(level->aliens.rowAlive.size());
+		header.columns = static_cast<unsigned int>(level->aliens.columnAlive.size());
+		header.alienCount = static_cast<unsigned int>(level->aliens.size());
+		header.shieldCount = static_cast<unsigned int>(level->shields.size());
+	}
+	header.laserCount = static_cast<unsigned int>(world.lasers.size());
+	header.explosionCount = static_cast<unsigned int>(world.explosions.size());
+	appendBytes(snapshot, &header, sizeof(header));
+
+	SnapshotState state = {};
+	state.time = world.time;
+	state.lastShotTime = world.lastShotTime;
+	state.lastHitTime = world.lastHitTime;
+	state.nextBlinkTime = world.nextBlinkTime;
+	state.rngState = world.rngState;
+	state.nextObjectId = world.nextObjectId;
+	state.levelNumber = world.levelNumber;
+	state.state = world.state;
+	state.playerPoints = world.playerPoints;
+	state.highScore = world.highScore;
+	state.mothershipHealth = world.mothershipHealth;
+	state.alienMovingRight = world.alienMovingRight;
+	state.mothershipAlive = world.mothershipAlive;
+	state.mothershipMovingRight = world.mothershipMovingRight;
+	state.isInvincible = world.isInvincible;
+	state.isBlinking = world.isBlinking;
+	if (level)
+	{
+		const AlienFormation & aliens = level->aliens;
+		saveEntity(state.playerShip, level->playerShip);
+		saveEntity(state.motherShip, level->motherShip);
+		state.playerHealth = level->playerHealth;
+		state.alienSpeed = level->alienSpeed;
+		state.origin[0] = aliens.origin.x;
+		state.origin[1] = aliens.origin.y;
+		state.origin[2] = aliens.origin.z;
+		state.slotZ0 = aliens.slotZ0;
+		state.firstColumn = aliens.firstColumn;
+		state.lastColumn = aliens.lastColumn;
+		state.topRow = aliens.topRow;
+		state.bottomRow = aliens.bottomRow;
+	}
+	appendBytes(snapshot, &state, sizeof(state));
+
+	if (level)
+	{
+		// The formation is already a structure of arrays, each array is copied as it is
+		const AlienFormation & aliens = level->aliens;
+		appendArray(snapshot, aliens.slotX);
+		appendArray(snapshot, aliens.slotY);
+		appendArray(snapshot, aliens.slotZ);
+		appendArray(snapshot, aliens.row);
+		appendArray(snapshot, aliens.col);
+		appendArray(snapshot, aliens.model);
+		appendArray(snapshot, aliens.id);
+		appendArray(snapshot, aliens.alive);
+		appendArray(snapshot, aliens.columnAlive);
+		appendArray(snapshot, aliens.rowAlive);
+		appendArray(snapshot, aliens.columnX);
+		appendArray(snapshot, aliens.rowY);
+		appendArray(snapshot, aliens.cellAlive);
+		appendArray(snapshot, aliens.frontRow);
+		appendArray(snapshot, level->columnNextShot);
+
+		for (const Shield & shield : level->shields)
+		{
+			SnapshotShield record = {};
+			saveEntity(record.obj, shield.obj);
+			record.health = shield.health;
+			appendBytes(snapshot, &record, sizeof(record));
+		}
+	}
+
+	for (const Laser & laser : world.lasers)
+	{
+		SnapshotLaser record = {};
+		for (int axis = 0; axis < 3; axis++)
+		{
+			record.position[axis] = laser.position[axis];
+			record.previousPosition[axis] = laser.previousPosition[axis];
+			record.direction[axis] = laser.direction[axis];
+		}
+		record.speed = laser.speed;
+		record.id = laser.id;
+		record.active = laser.active;
+		record.playerFriendly = laser.player_friendly;
+		appendBytes(snapshot, &record, sizeof(record));
+	}
+
+	appendArray(snapshot, world.explosions);
+
+	// The size is only known once everything is written
+	unsigned int size = static_cast<unsigned int>(snapshot.size());
+	memcpy(&snapshot[offsetof(SnapshotHeader, size)], &size, sizeof(size));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Reads the blocks of a snapshot in the order they were appended, reading past the end marks it as failed
+struct SnapshotReader
+{
+	const unsigned char * data;
+	size_t size;
+	size_t offset = 0;
+	bool failed = false;
+
+	SnapshotReader(const unsigned char * data, size_t size) : data(data), size(size) {}
+
+	// Start of the next block of bytes, NULL if the snapshot is too short
+	const unsigned char * next(size_t bytes)
+	{
+		if (failed || bytes > size - offset)
+		{
+			failed = true;
+			return NULL;
+		}
+		const unsigned char * block = data + offset;
+		offset += (bytes + SNAPSHOT_ALIGNMENT - 1) & ~static_cast<size_t>(SNAPSHOT_ALIGNMENT - 1);
+		if (offset > size)
+		{
+			offset = size;
+		}
+		return block;
+	}
+
+	template <typename Record>
+	bool read(Record & record)
+	{
+		const unsigned char * block = next(sizeof(Record));
+		if (block)
+		{
+			memcpy(&record, block, sizeof(Record));
+		}
+		return block != NULL;
+	}
+};
+
+// Function to copy the next count values of the snapshot into a container
+template <typename Array>
+static void readArray(SnapshotReader & reader, Array & values, size_t count)
+{
+	const unsigned char * block = reader.next(count * sizeof(values[0]));
+	values.resize(count);
+	if (block && count > 0)
+	{
+		memcpy(values.data(), block, count * sizeof(values[0]));
+	}
+}
+
+// Function to check that every value lies in [minimum, maximum)
+template <typename Array>
+static bool valuesInRange(const Array & values, int minimum, int maximum)
+{
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		if (values[i] < minimum || values[i] >= maximum)
+			return false;
+	}
+	return true;
+}
+
+static bool entityValid(const SnapshotEntity & record)
+{
+	return record.model >= 0 && record.model < MODEL_COUNT && record.kind >= ENTITY_NONE && record.kind <= ENTITY_ENEMY_LASER;
+}
+
+static void restoreEntity(const World & world, Entity & entity, const SnapshotEntity & record)
+{
+	entity.model = static_cast<ModelId>(record.model);
+	entity.kind = static_cast<EntityKind>(record.kind);
+	entity.position = glm::vec3(record.position[0], record.position[1], record.position[2]);
+	entity.scale = record.scale;
+	entity.bounds = scaleBounds(world.modelBounds[entity.model], entity.scale);
+	entity.id = record.id;
+	entity.alive = record.alive != 0;
+}
+
+bool restoreSnapshot(World & world, const unsigned char * data, size_t size)
+{
+	SnapshotReader reader(data, size);
+	SnapshotHeader header;
+	SnapshotState state;
+	if (!reader.read(header) || header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.size != size ||
+		header.definitionCount != world.definitions.size() || !reader.read(state) ||
+		header.laserCount > size / sizeof(SnapshotLaser) || header.explosionCount > size / sizeof(glm::vec3))
+	{
+		return false;
+	}
+
+	// The state is cast back to its enumeration, and a zero state would stop the xorshift sequence for good (see World::seedRandom)
+	if (state.state < GAME_START || state.state > GAME_RESET || state.rngState == 0)
+		return false;
+
+	// The game is played, paused or won on the level, those states cannot do without one
+	bool needsLevel = (state.state == GAME_PLAYING || state.state == GAME_PAUSED || state.state == NEW_LEVEL);
+	if (needsLevel && header.levelIndex == SNAPSHOT_NO_LEVEL)
+		return false;
+
+	// The level is rebuilt from its definition, the snapshot's grid must be the one the definition describes
+	const LevelDefinition * definition = NULL;
+	if (header.levelIndex != SNAPSHOT_NO_LEVEL)
+	{
+		if (header.levelIndex >= world.definitions.size())
+			return false;
+		definition = &world.definitions[header.levelIndex];
+		if (header.rows != static_cast<unsigned int>(definition->rowAliens) || header.columns != static_cast<unsigned int>(definition->colAliens) ||
+			header.alienCount > header.rows * header.columns || header.shieldCount > definition->shieldPositions.size() ||
+			!entityValid(state.playerShip) || !entityValid(state.motherShip))
+		{
+			return false;
+		}
+	}
+
+	// Everything is read and checked into a new level first, the world only changes once the whole snapshot proved valid
+	Level * level = NULL;
+	if (definition)
+	{
+		level = new Level(*definition, world.memory); // Reserves every container for the definition's grid and shields
+
+		AlienFormation & aliens = level->aliens;
+		size_t count = header.alienCount;
+		size_t cells = static_cast<size_t>(header.rows) * header.columns;
+		readArray(reader, aliens.slotX, count);
+		readArray(reader, aliens.slotY, count);
+		readArray(reader, aliens.slotZ, count);
+		readArray(reader, aliens.row, count);
+		readArray(reader, aliens.col, count);
+		readArray(reader, aliens.model, count);
+		readArray(reader, aliens.id, count);
+		readArray(reader, aliens.alive, count);
+		readArray(reader, aliens.columnAlive, header.columns);
+		readArray(reader, aliens.rowAlive, header.rows);
+		readArray(reader, aliens.columnX, header.columns);
+		readArray(reader, aliens.rowY, header.rows);
+		readArray(reader, aliens.cellAlive, cells);
+		readArray(reader, aliens.frontRow, header.columns);
+		readArray(reader, level->columnNextShot, header.columns);
+
+		for (unsigned int i = 0; i < header.shieldCount; i++)
+		{
+			SnapshotShield record;
+			if (!reader.read(record) || !entityValid(record.obj))
+			{
+				reader.failed = true;
+				break;
+			}
+			Shield shield;
+			restoreEntity(world, shield.obj, record.obj);
+			shield.health = record.health;
+			level->shields.push_back(shield);
+		}
+
+		// Rows, columns and models index the formation's grid and the model table when aliens die or are drawn
+		int rows = static_cast<int>(header.rows);
+		int columns = static_cast<int>(header.columns);
+		if (!valuesInRange(aliens.row, 0, rows) || !valuesInRange(aliens.col, 0, columns) ||
+			!valuesInRange(aliens.model, 0, ALIEN_MODEL_COUNT) || !valuesInRange(aliens.frontRow, -1, rows) ||
+			state.firstColumn < -1 || state.firstColumn >= columns || state.lastColumn < -1 || state.lastColumn >= columns ||
+			state.topRow < -1 || state.topRow >= rows || state.bottomRow < -1 || state.bottomRow >= rows)
+		{
+			reader.failed = true;
+		}
+
+		aliens.origin = glm::vec3(state.origin[0], state.origin[1], state.origin[2]);
+		aliens.slotZ0 = state.slotZ0;
+		aliens.firstColumn = state.firstColumn;
+		aliens.lastColumn = state.lastColumn;
+		aliens.topRow = state.topRow;
+		aliens.bottomRow = state.bottomRow;
+		restoreEntity(world, level->playerShip, state.playerShip);
+		restoreEntity(world, level->motherShip, state.motherShip);
+		level->playerHealth = state.playerHealth;
+		level->alienSpeed = state.alienSpeed;
+	}
+
+	std::vector<Laser> lasers(header.laserCount);
+	for (Laser & laser : lasers)
+	{
+		SnapshotLaser record;
+		if (!reader.read(record))
+			break;
+		laser.position = glm::vec3(record.position[0], record.position[1], record.position[2]);
+		laser.previousPosition = glm::vec3(record.previousPosition[0], record.previousPosition[1], record.previousPosition[2]);
+		laser.direction = glm::vec3(record.direction[0], record.direction[1], record.direction[2]);
+		laser.speed = record.speed;
+		laser.id = record.id;
+		laser.active = record.active != 0;
+		laser.player_friendly = record.playerFriendly != 0;
+		laser.kind = laser.player_friendly ? ENTITY_PLAYER_LASER : ENTITY_ENEMY_LASER;
+		laser.bounds = rotateBoundsZ(world.modelBounds[MODEL_LASER], laser.direction.x, laser.direction.y);
+	}
+
+	std::vector<glm::vec3> explosions;
+	readArray(reader, explosions, header.explosionCount);
+
+	if (reader.failed || reader.offset != size)
+	{
+		delete level;
+		return false;
+	}
+
+	// Swap the restored state in
+	world.unloadLevel();
+	world.level = level;
+	world.lasers.swap(lasers);
+	world.explosions.swap(explosions);
+
+	world.time = state.time;
+	world.lastShotTime = state.lastShotTime;
+	world.lastHitTime = state.lastHitTime;
+	world.nextBlinkTime = state.nextBlinkTime;
+	world.rngState = state.rngState;
+	world.nextObjectId = state.nextObjectId;
+	world.levelNumber = state.levelNumber;
+	world.state = static_cast<GameState>(state.state);
+	world.playerPoints = state.playerPoints;
+	world.highScore = state.highScore;
+	world.mothershipHealth = state.mothershipHealth;
+	world.alienMovingRight = state.alienMovingRight != 0;
+	world.mothershipAlive = state.mothershipAlive != 0;
+	world.mothershipMovingRight = state.mothershipMovingRight != 0;
+	world.isInvincible = state.isInvincible != 0;
+	world.isBlinking = state.isBlinking != 0;
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+bool writeSnapshotFile(const char * path, const std::vector<unsigned char> & snapshot)
+{
+	FILE * file = fopen(path, "wb");
+	if (!file)
+	{
+		printf("Impossible to open snapshot %s\n", path);
+		return false;
+	}
+
+	bool ok = fwrite(snapshot.data(), 1, snapshot.size(), file) == snapshot.size();
+	ok = (fclose(file) == 0) && ok;
+	return ok;
+}
+
+bool readSnapshotFile(const char * path, std::vector<unsigned char> & snapshot)
+{
+	FILE * file = fopen(path, "rb");
+	if (!file)
+	{
+		printf("Impossible to open snapshot %s\n", path);
+		return false;
+	}
+
+	// The file's real length, the size in a corrupt header must not decide how much is allocated
+	long length = -1;
+	if (fseek(file, 0, SEEK_END) == 0)
+	{
+		length = ftell(file);
+	}
+	bool ok = length >= static_cast<long>(sizeof(SnapshotHeader)) && fseek(file, 0, SEEK_SET) == 0;
+
+	// The header holds the size of the whole snapshot, it has to be a snapshot of this version and match the file
+	SnapshotHeader header;
+	ok = ok && fread(&header, 1, sizeof(header), file) == sizeof(header);
+	ok = ok && header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_VERSION && header.size == static_cast<unsigned long>(length);
+	if (ok)
+	{
+		snapshot.resize(header.size);
+		memcpy(snapshot.data(), &header, sizeof(header));
+		ok = fread(&snapshot[sizeof(header)], 1, header.size - sizeof(header), file) == header.size - sizeof(header);
+	}
+	if (!ok)
+	{
+		printf("Invalid snapshot %s\n", path);
+		snapshot.clear();
+	}
+	fclose(file);
+	return ok;
+}
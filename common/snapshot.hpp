@@ -0,0 +1,28 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "world.hpp"
+
+// Version of the snapshot layout, snapshots of any other version are refused
+#define SNAPSHOT_VERSION 1
+
+// Copy the whole state of a world between two steps into snapshot: level, aliens, shields, lasers, score, timers and
+// the random sequence. The snapshot is one block of fixed-size records followed by the formation's arrays as they are
+// in memory, so taking and restoring it is a series of memcpy calls. Its storage is reused, repeated snapshots of the
+// same level do not allocate.
+void saveSnapshot(const World & world, std::vector<unsigned char> & snapshot);
+
+// Put a world back in the state saved in a snapshot, its current level is replaced. The world must play the same level
+// definitions as the world the snapshot was taken from. Returns false and leaves the world untouched if the snapshot
+// is damaged or does not fit the definitions.
+bool restoreSnapshot(World & world, const unsigned char * data, size_t size);
+
+// Write a snapshot to a file, or read one back
+bool writeSnapshotFile(const char * path, const std::vector<unsigned char> & snapshot);
+bool readSnapshotFile(const char * path, std::vector<unsigned char> & snapshot);
+
+#endif
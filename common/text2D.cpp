@@ -9,6 +9,7 @@ using namespace glm;
 
 #include "shader.hpp"
 #include "texture.hpp"
+#include "memstats.hpp"
 
 #include "text2D.hpp"
 
@@ -18,11 +19,30 @@ unsigned int Text2DUVBufferID;
 unsigned int Text2DShaderID;
 unsigned int Text2DUniformID;
 
+// Bytes accounted for the font texture and the current size of the two vertex buffers
+size_t Text2DTextureBytes = 0;
+size_t Text2DBufferBytes = 0;
+
+// Draw calls issued since startup
+unsigned int Text2DDrawCalls = 0;
+
 void initText2D(const char * texturePath){
 
 	// Initialize texture
 	Text2DTextureID = loadDDS(texturePath);
 
+	// Account the compressed size of every mipmap level of the font
+	glBindTexture(GL_TEXTURE_2D, Text2DTextureID);
+	for (int level = 0; ; level++){
+		GLint width = 0, levelBytes = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+		if (width == 0)
+			break;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &levelBytes);
+		Text2DTextureBytes += levelBytes;
+	}
+	memAdd(MEM_TEXTURES, Text2DTextureBytes);
+
 	// Initialize VBO
 	glGenBuffers(1, &Text2DVertexBufferID);
 	glGenBuffers(1, &Text2DUVBufferID);
@@ -79,6 +99,11 @@ void printText2D(const char * text, int x, int y, int size){
 	glBindBuffer(GL_ARRAY_BUFFER, Text2DUVBufferID);
 	glBufferData(GL_ARRAY_BUFFER, UVs.size() * sizeof(glm::vec2), &UVs[0], GL_STATIC_DRAW);
 
+	// Both buffers were just resized to this string
+	memRemove(MEM_TEXT_BUFFERS, Text2DBufferBytes);
+	Text2DBufferBytes = (vertices.size() + UVs.size()) * sizeof(glm::vec2);
+	memAdd(MEM_TEXT_BUFFERS, Text2DBufferBytes);
+
 	// Bind shader
 	glUseProgram(Text2DShaderID);
 
@@ -103,6 +128,7 @@ void printText2D(const char * text, int x, int y, int size){
 
 	// Draw call
 	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+	Text2DDrawCalls++;
 
 	glDisable(GL_BLEND);
 
@@ -120,6 +146,15 @@ void cleanupText2D(){
 	// Delete texture
 	glDeleteTextures(1, &Text2DTextureID);
 
+	memRemove(MEM_TEXT_BUFFERS, Text2DBufferBytes);
+	memRemove(MEM_TEXTURES, Text2DTextureBytes);
+	Text2DBufferBytes = 0;
+	Text2DTextureBytes = 0;
+
 	// Delete shader
 	glDeleteProgram(Text2DShaderID);
 }
+
+unsigned int getText2DDrawCalls(){
+	return Text2DDrawCalls;
+}
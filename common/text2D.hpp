@@ -4,5 +4,6 @@
 void initText2D(const char * texturePath);
 void printText2D(const char * text, int x, int y, int size);
 void cleanupText2D();
+unsigned int getText2DDrawCalls();
 
 #endif
\ No newline at end of file
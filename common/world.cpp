@@ -0,0 +1,714 @@
+#include <math.h>
+
+#include "log.hpp"
+#include "world.hpp"
+
+const char * const entityKindNames[] = { "None", "Player", "Alien", "MotherShip", "Shield", "Player Laser", "Enemy Laser" };
+
+const ModelId alienModels[ALIEN_MODEL_COUNT] = { MODEL_ALIEN1, MODEL_ALIEN2, MODEL_ALIEN3 };
+
+const ModelFiles modelFiles[MODEL_COUNT] =
+{
+	{ "obj/player.obj",     "obj" },
+	{ "obj/alien1.obj",     "obj" },
+	{ "obj/alien2.obj",     "obj" },
+	{ "obj/alien3.obj",     "obj" },
+	{ "obj/mothership.obj", "obj" },
+	{ "obj/shield.obj",     "obj" },
+	{ "obj/laser.obj",      "obj" },
+	{ "obj/explosion.obj",  "obj" }
+};
+
+
+//-------------------------------------------------------------------------------------------------
+Level::Level(const LevelDefinition & definition, std::pmr::memory_resource * upstream)
+	: arena(definition.spawnTable.size() * ALIEN_BYTES + definition.shieldPositions.size() * sizeof(Shield) +
+		definition.colAliens * sizeof(double) + LEVEL_ARENA_BASE_SIZE, upstream),
+	aliens(&arena), shields(&arena), columnNextShot(&arena),
+	definition(definition), playerHealth(definition.playerHealth), alienSpeed(definition.alienSpeed)
+{
+	// The containers are allocated once, compaction never grows them
+	aliens.reserve(definition.rowAliens, definition.colAliens);
+	shields.reserve(definition.shieldPositions.size());
+	columnNextShot.assign(definition.colAliens, -1.0);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+World::World(const std::vector<LevelDefinition> & definitions, const Bounds * modelBounds, unsigned int seed, std::pmr::memory_resource * memory)
+	: definitions(definitions), modelBounds(modelBounds), memory(memory)
+{
+	seedRandom(seed);
+}
+
+World::~World()
+{
+	unloadLevel();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void World::seedRandom(unsigned int seed)
+{
+	// Scramble the seed so nearby seeds start far apart, xorshift never leaves a zero state so it is avoided
+	rngState = seed * 2654435761u + 0x9E3779B9u;
+	if (rngState == 0)
+	{
+		rngState = 1;
+	}
+}
+
+float World::random01()
+{
+	// xorshift32: the whole state is one word, cheap to copy into a snapshot
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return static_cast<float>(rngState >> 8) / 16777216.0f;
+}
+
+int World::generateUniqueID()
+{
+	return nextObjectId++;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to place an entity of a model, its bounds follow the model's at the entity's scale
+static void placeEntity(World & world, Entity & entity, ModelId model, EntityKind kind, const glm::vec3 & position, float scale)
+{
+	entity.model = model;
+	entity.kind = kind;
+	entity.position = position;
+	entity.scale = scale;
+	entity.bounds = scaleBounds(world.modelBounds[model], scale);
+	entity.id = world.generateUniqueID();
+	entity.alive = true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to create the level's entities: player, mothership, shields and aliens
+static void populateLevel(World & world, Level & level)
+{
+	const LevelDefinition & definition = level.definition;
+
+	// Player lower in the scene, drawn at half size
+	placeEntity(world, level.playerShip, MODEL_PLAYER, ENTITY_PLAYER, glm::vec3(0.0f, -35.0f, 0.0f), 0.5f);
+
+	// Mothership above the formation, drawn at half size
+	placeEntity(world, level.motherShip, MODEL_MOTHERSHIP, ENTITY_MOTHERSHIP, glm::vec3(0.0f, 30.0f, 0.0f), 0.5f);
+	world.mothershipAlive = true;
+	world.mothershipHealth = definition.motherShipHealth;
+	world.mothershipMovingRight = true;
+	LOG_DEBUG("Mothership created with health: %d", world.mothershipHealth);
+
+	// Shields drawn five times larger than their model
+	for (const glm::vec3 & position : definition.shieldPositions)
+	{
+		Shield shield;
+		placeEntity(world, shield.obj, MODEL_SHIELD, ENTITY_SHIELD, position, 5.0f);
+		shield.health = definition.shieldHealth;
+		level.shields.push_back(shield);
+	}
+
+	// Spawn positions were already computed when the level file was loaded.
+	// The formation's origin starts at zero, so each alien's slot is simply its spawn position.
+	for (const AlienSpawn & spawn : definition.spawnTable)
+	{
+		level.aliens.add(spawn.position, spawn.row, spawn.col, spawn.model, world.generateUniqueID());
+	}
+	world.alienMovingRight = true;
+
+	LOG_DEBUG("Created: %d Aliens!", static_cast<int>(level.aliens.size()));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void World::startLevel(int number)
+{
+	unloadLevel();
+
+	levelNumber = number;
+
+	// Levels past the last definition replay the last one
+	size_t index = static_cast<size_t>(levelNumber - 1);
+	if (index >= definitions.size())
+	{
+		index = definitions.size() - 1;
+	}
+
+	level = new Level(definitions[index], memory);
+	populateLevel(*this, *level);
+
+	// A new level starts without the previous one's shots and invincibility
+	isInvincible = false;
+	isBlinking = false;
+}
+
+void World::startNextLevel()
+{
+	startLevel(levelNumber + 1);
+}
+
+void World::unloadLevel()
+{
+	// The level's arena frees all of its entities in a few large blocks
+	delete level;
+	level = nullptr;
+
+	lasers.clear();
+	events.clear();
+	explosions.clear();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to move the player and fire a laser when the controls ask for it
+void handlePlayerMovement(World & world, const PlayerInput & input, float deltaTime)
+{
+	Entity & player = world.level->playerShip;
+
+	// Move player left
+	if (input.left)
+	{
+		player.position.x -= PLAYER_SPEED * deltaTime;
+	}
+
+	// Move player right
+	if (input.right)
+	{
+		player.position.x += PLAYER_SPEED * deltaTime;
+	}
+
+	// Ensure player stays within the screen boundaries
+	if (player.position.x < LEFTBOUNDARY)
+	{
+		player.position.x = LEFTBOUNDARY; // Prevent movement beyond the left boundary
+	}
+	if (player.position.x > RIGHTBOUNDARY)
+	{
+		player.position.x = RIGHTBOUNDARY; // Prevent movement beyond the right boundary
+	}
+
+	// Fire a laser when fire is held and cooldown time has passed
+	if (input.fire && (world.time - world.lastShotTime) >= SHOT_COOLDOWN)
+	{
+		Laser newLaser;
+		createLaser(world, newLaser, player.position, player.position + glm::vec3(0.0f, 2.0f, 0.0f), true); // Fire laser above the player
+		world.lasers.push_back(newLaser);
+		world.lastShotTime = world.time; // Update last shot time for cooldown management
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to update the mothership's position
+void updateMothershipPosition(World & world)
+{
+	Entity & motherShip = world.level->motherShip;
+
+	// Reverse direction if mothership hits screen boundaries
+	if (motherShip.position.x < LEFTBOUNDARY || motherShip.position.x > RIGHTBOUNDARY)
+	{
+		world.mothershipMovingRight = !world.mothershipMovingRight;
+	}
+
+	// Move the mothership based on its direction
+	motherShip.position.x += world.mothershipMovingRight ? mothershipSpeed : -mothershipSpeed;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to update laser position
+void updateLaser(Laser & laser, float deltaTime)
+{
+	if (!laser.active)
+		return; // Skip if laser is inactive
+
+	// Move the laser in its direction based on speed and delta time, remembering where the step started
+	laser.previousPosition = laser.position;
+	laser.position += laser.direction * laser.speed * deltaTime;
+
+	// Deactivate laser if it moves off the screen (y-axis or x-axis exceeds a certain limit)
+	if (laser.position.y > 35.0f || laser.position.y < -35.0f || laser.position.x > 55.0f || laser.position.x < -55.0f)
+	{
+		laser.active = false;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to create a laser
+void createLaser(World & world, Laser & laser, const glm::vec3 & playerPosition, const glm::vec3 & startPos, bool player_shot, const glm::vec3 & alienPosition)
+{
+	// Set the laser's position in the game world
+	laser.position = startPos;
+	laser.previousPosition = startPos;
+
+	laser.id = world.generateUniqueID();
+
+	if (player_shot)
+	{
+		laser.player_friendly = true;
+		laser.kind = ENTITY_PLAYER_LASER;
+		laser.direction = glm::vec3(0.0f, 1.0f, 0.0f); // Laser moves upwards
+	}
+	else
+	{
+		laser.player_friendly = false;
+		laser.kind = ENTITY_ENEMY_LASER;
+
+		if (alienPosition != glm::vec3(0.0f, 0.0f, 0.0f))
+		{
+			// Aim from the alien at the player
+			laser.direction = glm::normalize(playerPosition - alienPosition);
+		}
+		else
+		{
+			laser.direction = glm::vec3(0.0f, -1.0f, 0.0f); // Straight down by default
+		}
+	}
+
+	// The laser is drawn pointing along its direction, its box is turned the same way once here
+	laser.bounds = rotateBoundsZ(world.modelBounds[MODEL_LASER], laser.direction.x, laser.direction.y);
+
+	laser.active = true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to handle mothership laser firing
+void handleMothershipLaserFiring(World & world)
+{
+	// Random chance for mothership to fire
+	if (world.random01() < mothershipFireChance)
+	{
+		Laser newLaser;
+		createLaser(world, newLaser, world.level->playerShip.position, world.level->motherShip.position + glm::vec3(0.0f, -2.0f, 0.0f), false);
+		world.lasers.push_back(newLaser);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to handle alien laser firing
+void handleAlienLaserFiring(World & world)
+{
+	const AlienFormation & aliens = world.level->aliens;
+	std::pmr::vector<double> & columnNextShot = world.level->columnNextShot;
+
+	// One check per column instead of a dice roll per alien: the aliens behind the frontline would only shoot their own row
+	for (int column = 0; column < aliens.columns(); column++)
+	{
+		glm::vec3 alienPosition;
+		if (!aliens.frontline(column, alienPosition))
+		{
+			continue; // The whole column was destroyed
+		}
+
+		if (columnNextShot[column] >= 0.0 && world.time < columnNextShot[column])
+		{
+			continue; // Still cooling down
+		}
+
+		// A column fires when its cooldown runs out, not yet when it is first scheduled
+		if (columnNextShot[column] >= 0.0)
+		{
+			Laser newLaser;
+			createLaser(world, newLaser, world.level->playerShip.position, alienPosition + glm::vec3(0.0f, -2.0f, 0.0f), false, alienPosition);
+			world.lasers.push_back(newLaser);
+		}
+
+		// Jitter the cooldown by +-50% so the columns drift apart instead of firing in volleys
+		float jitter = 0.5f + world.random01();
+		columnNextShot[column] = world.time + world.level->definition.alienFireInterval * jitter;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to sweep a laser's bounding box over its last step against a bounding box placed at position
+bool sweepLaserAgainst(const Laser & laser, const glm::vec3 & position, const Bounds & bounds, float & hitT)
+{
+	// Grow the target's box by the laser's half size, then only the laser's center has to be swept
+	glm::vec3 laserHalfSize = (laser.bounds.max - laser.bounds.min) * 0.5f;
+	glm::vec3 laserCenter = (laser.bounds.max + laser.bounds.min) * 0.5f;
+	glm::vec3 boxMin = position + bounds.min - laserHalfSize;
+	glm::vec3 boxMax = position + bounds.max + laserHalfSize;
+
+	return segmentAABBIntersect(laser.previousPosition + laserCenter, laser.position + laserCenter, boxMin, boxMax, hitT);
+}
+
+// Function to sweep a laser's bounding box over its last step against an entity's bounding box
+static bool sweepLaserAgainst(const Laser & laser, const Entity & target, float & hitT)
+{
+	return sweepLaserAgainst(laser, target.position, target.bounds, hitT);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to find laser collisions with the mothership
+void findLaserMothershipCollision(const World & world, std::vector<GameEvent> & events)
+{
+	if (!world.mothershipAlive)
+	{
+		return;
+	}
+
+	for (size_t l = 0; l < world.lasers.size(); l++)
+	{
+		const Laser & laser = world.lasers[l];
+		float hitT = 0.0f;
+		if (laser.active && laser.player_friendly && sweepLaserAgainst(laser, world.level->motherShip, hitT))
+		{
+			events.push_back({ EVENT_MOTHERSHIP_HIT, static_cast<int>(l), 0 });
+			break; // Stop checking once a laser hits the mothership
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to find collisions between lasers and aliens
+void findLaserAlienCollisions(const World & world, std::vector<GameEvent> & events)
+{
+	const AlienFormation & aliens = world.level->aliens;
+
+	// Broad phase: bounding box of the whole formation, the extent of the living aliens grown by the largest model box
+	Bounds formation;
+	float minX = 0.0f, maxX = 0.0f, minY = 0.0f, maxY = 0.0f, minZ = 0.0f, maxZ = 0.0f;
+	if (aliens.extentX(minX, maxX) && aliens.extentY(minY, maxY) && valueRange(aliens.slotZ.data(), aliens.size(), minZ, maxZ))
+	{
+		Bounds models = world.modelBounds[alienModels[0]];
+		for (ModelId model : alienModels)
+		{
+			models.min = glm::min(models.min, world.modelBounds[model].min);
+			models.max = glm::max(models.max, world.modelBounds[model].max);
+		}
+		formation.min = glm::vec3(minX, minY, aliens.origin.z + minZ) + models.min;
+		formation.max = glm::vec3(maxX, maxY, aliens.origin.z + maxZ) + models.max;
+	}
+
+	for (size_t l = 0; l < world.lasers.size(); l++)
+	{
+		const Laser & laser = world.lasers[l];
+		float hitT = 0.0f;
+
+		// Skip inactive lasers and lasers whose sweep does not come near the formation
+		if (!laser.active || aliens.empty() || !laser.player_friendly || !sweepLaserAgainst(laser, glm::vec3(0.0f), formation, hitT))
+		{
+			continue;
+		}
+
+		// Narrow phase: find the first living alien along the laser's sweep
+		size_t hitAlien = aliens.size();
+		float firstHitT = 2.0f;
+		for (size_t i = 0; i < aliens.size(); i++)
+		{
+			if (aliens.alive[i] && sweepLaserAgainst(laser, aliens.position(i), world.modelBounds[alienModels[aliens.model[i]]], hitT) && hitT < firstHitT)
+			{
+				firstHitT = hitT;
+				hitAlien = i;
+			}
+		}
+
+		if (hitAlien < aliens.size())
+		{
+			events.push_back({ EVENT_ALIEN_HIT, static_cast<int>(l), static_cast<int>(hitAlien) });
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to find collisions between lasers and shields
+void findLaserShieldCollisions(const World & world, std::vector<GameEvent> & events)
+{
+	const std::pmr::vector<Shield> & shields = world.level->shields;
+	for (size_t l = 0; l < world.lasers.size(); l++)
+	{
+		if (!world.lasers[l].active)
+		{
+			continue; // Skip inactive lasers
+		}
+
+		for (size_t s = 0; s < shields.size(); s++)
+		{
+			float hitT = 0.0f;
+			if (shields[s].obj.alive && sweepLaserAgainst(world.lasers[l], shields[s].obj, hitT))
+			{
+				events.push_back({ EVENT_SHIELD_HIT, static_cast<int>(l), static_cast<int>(s) });
+				break; // Stop checking once a laser hits a shield
+			}
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to find collisions between lasers and the player
+void findLaserPlayerCollisions(const World & world, std::vector<GameEvent> & events)
+{
+	// The player cannot be hit while the invincibility period after the last hit lasts
+	if (world.isInvincible && (world.time - world.lastHitTime) < INVINCIBILITY_DURATION)
+	{
+		return;
+	}
+
+	for (size_t l = 0; l < world.lasers.size(); l++)
+	{
+		const Laser & laser = world.lasers[l];
+		float hitT = 0.0f;
+		if (laser.active && !laser.player_friendly && sweepLaserAgainst(laser, world.level->playerShip, hitT))
+		{
+			events.push_back({ EVENT_PLAYER_HIT, static_cast<int>(l), 0 });
+			break; // Stop checking once a laser hits the player
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to apply the side effects of this tick's collisions: damage, kills, points, explosions and state changes
+void applyGameEvents(World & world)
+{
+	Level & level = *world.level;
+
+	// Reset the invincibility flag once its period has expired
+	if (world.isInvincible && (world.time - world.lastHitTime) >= INVINCIBILITY_DURATION)
+	{
+		world.isInvincible = false;
+	}
+
+	for (const GameEvent & event : world.events)
+	{
+		// Every pass looked at the same lasers, a laser only counts for the first thing it hit.
+		// The passes ran mothership, aliens, shields, player, so that is also the priority of a hit.
+		Laser & laser = world.lasers[event.laser];
+		if (!laser.active)
+		{
+			continue;
+		}
+
+		switch (event.type)
+		{
+		case EVENT_MOTHERSHIP_HIT:
+			if (!world.mothershipAlive)
+			{
+				continue;
+			}
+			world.mothershipHealth -= 1; // Decrease mothership health on hit
+			laser.active = false;        // Deactivate the laser after collision
+
+			if (world.mothershipHealth <= 0)
+			{
+				world.mothershipAlive = false;
+				LOG_DEBUG("Mothership Destroyed!");
+
+				world.playerPoints += 50; // Add 500 points for each mothership destroyed
+				world.explosions.push_back(level.motherShip.position);
+			}
+			break;
+
+		case EVENT_ALIEN_HIT:
+			if (!level.aliens.alive[event.target])
+			{
+				continue; // Another laser got there first, this one keeps flying
+			}
+
+			world.explosions.push_back(level.aliens.position(event.target));
+			world.playerPoints += 5; // Add 50 points for each alien destroyed
+
+			level.aliens.kill(event.target); // Mark the alien dead, it is removed at the end of the tick
+			laser.active = false;            // Deactivate the laser after collision
+			break;
+
+		case EVENT_SHIELD_HIT:
+		{
+			Shield & shield = level.shields[event.target];
+			if (!shield.obj.alive)
+			{
+				continue;
+			}
+
+			laser.active = false; // Deactivate the laser after collision
+
+			// Friendly lasers are stopped without affecting shield health
+			if (!laser.player_friendly)
+			{
+				shield.health -= 1;
+				if (shield.health <= 0)
+				{
+					shield.obj.alive = false; // Mark the shield destroyed, it is removed at the end of the tick
+				}
+			}
+			break;
+		}
+
+		case EVENT_PLAYER_HIT:
+			if (world.isInvincible)
+			{
+				continue; // Only the first hit of a tick counts
+			}
+
+			level.playerHealth -= 1; // Decrease player health on hit
+			laser.active = false;    // Deactivate the laser after collision
+
+			if (level.playerHealth <= 0)
+			{
+				world.state = GAME_OVER;
+				LOG_DEBUG("Player Killed!");
+			}
+			else
+			{
+				world.isInvincible = true;
+				world.lastHitTime = world.time;
+				world.nextBlinkTime = world.time;
+				LOG_DEBUG("Player Hit! Invincibility activated.");
+			}
+			break;
+		}
+	}
+
+	world.events.clear();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Functions telling whether an entity died during the tick
+static bool isEntityDead(const Shield & shield) { return !shield.obj.alive; }
+static bool isEntityDead(const Laser & laser) { return !laser.active; }
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to remove every dead entity of a container in a single pass.
+// Each hole is filled by moving the last entity into it (swap-and-pop), so removal is O(1) per entity.
+// Entity order is not preserved, entities keep their id so anything referring to them by id stays valid.
+template <typename Container>
+static void compactEntities(Container & entities)
+{
+	size_t i = 0;
+	while (i < entities.size())
+	{
+		if (isEntityDead(entities[i]))
+		{
+			if (i + 1 != entities.size())
+			{
+				entities[i] = entities.back(); // Fill the hole with the last entity
+			}
+			entities.pop_back();
+		}
+		else
+		{
+			i++; // Keep the entity
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to remove everything that died during the tick, called once at the end of the simulation step
+void removeDeadEntities(World & world)
+{
+	compactFormation(world.level->aliens);
+	compactEntities(world.level->shields);
+	compactEntities(world.lasers);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void World::step(const PlayerInput & input, float deltaTime)
+{
+	if (state != GAME_PLAYING || !level)
+	{
+		return;
+	}
+
+	time += deltaTime;
+	explosions.clear();
+
+	handlePlayerMovement(*this, input, deltaTime);
+
+	// The whole grid moves in lockstep, so only the formation's origin moves. The boundary is checked against
+	// the outermost living columns, which the formation keeps up to date as aliens die.
+	alienMovingRight = stepFormation(level->aliens, alienMovingRight, level->alienSpeed, alienDropDistance, LEFTBOUNDARY, RIGHTBOUNDARY);
+
+	// Move lasers before any collision test, collisions sweep over this tick's movement
+	for (Laser & laser : lasers)
+	{
+		updateLaser(laser, deltaTime);
+	}
+
+	// Toggle the player's visibility while the invincibility period lasts
+	if (isInvincible)
+	{
+		if (time >= nextBlinkTime)
+		{
+			isBlinking = !isBlinking;
+			nextBlinkTime = time + BLINK_INTERVAL;
+		}
+	}
+	else
+	{
+		isBlinking = false;
+	}
+
+	// The mothership only moves and fires while it is alive
+	if (mothershipAlive)
+	{
+		updateMothershipPosition(*this);
+		handleMothershipLaserFiring(*this);
+		findLaserMothershipCollision(*this, events);
+	}
+
+	handleAlienLaserFiring(*this);
+
+	// The collision passes only read the world, their hits take effect in applyGameEvents in one place
+	findLaserAlienCollisions(*this, events);
+	findLaserShieldCollisions(*this, events);
+	findLaserPlayerCollisions(*this, events);
+	applyGameEvents(*this);
+
+	// Remove everything that died this tick in one compaction pass
+	removeDeadEntities(*this);
+
+	if (level->aliens.empty() && state == GAME_PLAYING)
+	{
+		LOG_DEBUG("LEVEL WON!");
+		LOG_DEBUG("POINTS -> %d", playerPoints);
+		state = NEW_LEVEL;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to produce the controls of a simple bot.
+// It chases the lowest alien (the closest one on ties) and fires whenever it is roughly underneath it.
+PlayerInput scriptedPlayerInput(const World & world)
+{
+	PlayerInput input;
+	const glm::vec3 & player = world.level->playerShip.position;
+
+	const AlienFormation & aliens = world.level->aliens;
+	float playerSlotX = player.x - aliens.origin.x; // Compare in slot space, every alien shares the origin
+	size_t target = aliens.size();
+	for (size_t i = 0; i < aliens.size(); i++)
+	{
+		if (target == aliens.size() || aliens.slotY[i] < aliens.slotY[target] - 0.01f ||
+			(aliens.slotY[i] < aliens.slotY[target] + 0.01f && fabs(aliens.slotX[i] - playerSlotX) < fabs(aliens.slotX[target] - playerSlotX)))
+		{
+			target = i;
+		}
+	}
+
+	if (target < aliens.size())
+	{
+		float dx = aliens.slotX[target] - playerSlotX;
+		input.left = dx < -1.0f;
+		input.right = dx > 1.0f;
+		input.fire = fabs(dx) < 2.0f;
+	}
+
+	return input;
+}
@@ -0,0 +1,274 @@
+#ifndef WORLD_HPP
+#define WORLD_HPP
+
+#include <memory_resource>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "collision.hpp"
+#include "formation.hpp"
+#include "levelfile.hpp"
+
+// Gameplay tuning, the same for every world (the playfield boundaries are in levelfile.hpp, levels are checked against them)
+const float alienDropDistance = 0.5f;           // Distance that aliens move down when they hit a boundary
+const float mothershipSpeed = 0.05f;            // Speed at which the mothership moves horizontally
+const float mothershipFireChance = 5.0f / 300.0f; // Chance of the mothership firing in a tick
+const float PLAYER_SPEED = 20.0f;               // Speed at which the player can move
+const float SHOT_COOLDOWN = 0.3f;               // Cooldown duration for shooting
+const float INVINCIBILITY_DURATION = 3.0f;      // Duration of invincibility in seconds
+const float BLINK_INTERVAL = 0.2f;              // Interval between blinks in seconds
+
+// Initial size of a level's arena on top of its aliens and shields
+const size_t LEVEL_ARENA_BASE_SIZE = 64 * 1024;
+
+// Bytes one alien takes in the formation's arrays and its grid cell (see AlienFormation)
+const size_t ALIEN_BYTES = 3 * sizeof(float) + 4 * sizeof(int) + 2 * sizeof(unsigned char);
+
+
+// Kinds of entities in the game
+enum EntityKind
+{
+	ENTITY_NONE,
+	ENTITY_PLAYER,
+	ENTITY_ALIEN,
+	ENTITY_MOTHERSHIP,
+	ENTITY_SHIELD,
+	ENTITY_PLAYER_LASER,
+	ENTITY_ENEMY_LASER
+};
+
+// Names of the entity kinds, only used for debug output
+extern const char * const entityKindNames[];
+
+// Interned IDs of every model, entities store the ID and the renderer maps it to its mesh
+enum ModelId
+{
+	MODEL_NONE = -1,
+	MODEL_PLAYER,
+	MODEL_ALIEN1,
+	MODEL_ALIEN2,
+	MODEL_ALIEN3,
+	MODEL_MOTHERSHIP,
+	MODEL_SHIELD,
+	MODEL_LASER,
+	MODEL_EXPLOSION,
+	MODEL_COUNT
+};
+
+// Model of each alien model index of the spawn table
+extern const ModelId alienModels[ALIEN_MODEL_COUNT];
+
+// Files of each model, the renderer uploads them and the batch runner only reads their bounds
+struct ModelFiles
+{
+	const char * objFile;   // Path to the .obj file containing the 3D model
+	const char * mtlFile;   // Folder of the material (.mtl) file associated with the model
+};
+
+// Files of every model, indexed by ModelId
+extern const ModelFiles modelFiles[MODEL_COUNT];
+
+// States of a game
+enum GameState
+{
+	GAME_START,
+	GAME_PLAYING,
+	GAME_PAUSED,
+	GAME_OVER,
+	NEW_LEVEL,
+	NEW_LEVEL_START,
+	GAME_RESET
+};
+
+// Player's controls for one tick, read from the keyboard or produced by a bot
+struct PlayerInput
+{
+	bool left = false;   // Move left
+	bool right = false;  // Move right
+	bool fire = false;   // Fire a laser (subject to the shot cooldown)
+};
+
+// Something placed in the world (player, mothership, shield), the renderer draws its model at its position
+struct Entity
+{
+	ModelId model = MODEL_NONE;            // Model the entity is drawn and collided with
+	glm::vec3 position = glm::vec3(0.0f);  // Position in the world
+	float scale = 1.0f;                    // Uniform scale the model is drawn with
+	Bounds bounds;                         // Bounding volumes of the model with the scale applied
+	int id = -1;                           // Unique identifier
+	bool alive = true;                     // Cleared when the entity is killed, dead entities are removed at the end of the tick
+	EntityKind kind = ENTITY_NONE;
+};
+
+// Laser shot fired by the player or enemies
+struct Laser
+{
+	glm::vec3 direction = glm::vec3(0.0f, 1.0f, 0.0f); // Direction the laser moves in (default is upwards)
+	float speed = 10.0f;                               // Speed at which the laser moves
+	bool active = false;                               // Whether the laser is still flying
+	bool player_friendly = true;                       // Fired by the player (true) or by an alien (false)
+	glm::vec3 position = glm::vec3(0.0f);              // Position of the laser in the game world
+	glm::vec3 previousPosition = glm::vec3(0.0f);      // Position before the last update, collisions sweep from here to position
+	Bounds bounds;                                     // Bounding volumes of the laser model turned along direction
+	int id = -1;                                       // Unique identifier
+	EntityKind kind = ENTITY_NONE;                     // Player or enemy laser
+};
+
+// Shield protecting the player
+struct Shield
+{
+	Entity obj;
+	int health = 10;
+};
+
+// Kinds of collisions the collision passes report, applied in this order within a tick
+enum GameEventType
+{
+	EVENT_MOTHERSHIP_HIT,  // A player laser hit the mothership, target unused
+	EVENT_ALIEN_HIT,       // A player laser hit an alien, target is its index in the formation
+	EVENT_SHIELD_HIT,      // A laser hit a shield, target is its index in the level's shields
+	EVENT_PLAYER_HIT       // An alien laser hit the player, target unused
+};
+
+// Collision found during the simulation step, its side effects are applied after all passes ran
+struct GameEvent
+{
+	GameEventType type;
+	int laser;   // Index of the laser in the world's lasers
+	int target;  // Index of what it hit, see GameEventType
+};
+
+
+// Entities of one level. Everything is allocated from the level's arena, which is released in one go with the level.
+class Level
+{
+public:
+	std::pmr::monotonic_buffer_resource arena; // Declared first so it outlives every container of the level
+
+	AlienFormation aliens;                  // Grid slots and state of every alien around the formation's origin
+	std::pmr::vector<Shield> shields;
+	std::pmr::vector<double> columnNextShot; // Time each formation column fires next, negative until it is first scheduled
+	Entity playerShip;
+	Entity motherShip;
+	const LevelDefinition & definition;     // Level description, owned by whoever owns the world's definitions
+	int playerHealth;
+	float alienSpeed;
+
+	// Reserve every container of the level in an arena allocated from upstream
+	Level(const LevelDefinition & definition, std::pmr::memory_resource * upstream);
+
+	Level(const Level &) = delete;
+	Level & operator=(const Level &) = delete;
+};
+
+
+// One independent game: its levels, entities, clock, random numbers and score.
+// A world never touches OpenGL or any global state, so any number of them can be simulated at once on different threads.
+// The renderer reads it after each step, explosions started by a step are listed in explosions.
+class World
+{
+public:
+	const std::vector<LevelDefinition> & definitions; // Every level, shared by all worlds and never written
+	const Bounds * modelBounds;              // Unscaled bounds of each model (MODEL_COUNT entries), shared by all worlds and never written
+	std::pmr::memory_resource * memory;      // Upstream of the level arenas
+
+	Level * level = nullptr;                 // Level being played
+	int levelNumber = 0;                     // 1 = first level
+	GameState state = GAME_START;
+
+	double time = 0.0;                       // Simulation clock, seconds played, only advanced by step
+	unsigned int rngState = 1;               // State of the world's random sequence, see random01
+	int nextObjectId = 0;                    // Next unique identifier handed out
+
+	int playerPoints = 0;
+	int highScore = 0;
+
+	bool alienMovingRight = true;            // Current direction of the alien formation
+
+	bool mothershipAlive = false;
+	int mothershipHealth = 10;
+	bool mothershipMovingRight = true;
+
+	double lastShotTime = -SHOT_COOLDOWN;    // When the player fired last, so the first shot is never held back
+	double lastHitTime = -INVINCIBILITY_DURATION; // When the player was hit last
+	bool isInvincible = false;               // The player cannot be hit right after being hit
+	bool isBlinking = false;                 // The player is hidden while blinking during invincibility
+	double nextBlinkTime = 0.0;
+
+	std::vector<Laser> lasers;               // Active lasers of both sides
+	std::vector<GameEvent> events;           // Collisions found during the current step
+	std::vector<glm::vec3> explosions;       // Positions of the explosions started by the last step
+
+	// Create a world without a level, seed starts its random sequence
+	World(const std::vector<LevelDefinition> & definitions, const Bounds * modelBounds, unsigned int seed, std::pmr::memory_resource * memory = std::pmr::new_delete_resource());
+	~World();
+
+	// Worlds own their level, they are constructed in place and never copied
+	World(const World &) = delete;
+	World & operator=(const World &) = delete;
+
+	// Start a level (1 = first level), levels past the last definition replay the last one
+	void startLevel(int number);
+
+	// Start the level after the current one
+	void startNextLevel();
+
+	// Delete the current level and every laser in flight
+	void unloadLevel();
+
+	// Advance the game by deltaTime seconds with the player's controls, only while playing.
+	// Moves everything, fires, resolves collisions and removes what died; a cleared level switches to NEW_LEVEL
+	// and a lost one to GAME_OVER.
+	void step(const PlayerInput & input, float deltaTime);
+
+	// Restart the world's random sequence from seed, e.g. so games restored from one snapshot play out differently
+	void seedRandom(unsigned int seed);
+
+	// Next value of the world's random sequence in [0, 1)
+	float random01();
+
+	// Hand out the next unique identifier
+	int generateUniqueID();
+};
+
+
+// Functions of the simulation step, in the order step runs them
+
+// Function to move the player and fire a laser when the controls ask for it
+void handlePlayerMovement(World & world, const PlayerInput & input, float deltaTime);
+
+// Function to update the mothership's position
+void updateMothershipPosition(World & world);
+
+// Function to update laser position
+void updateLaser(Laser & laser, float deltaTime);
+
+// Function to handle mothership laser firing
+void handleMothershipLaserFiring(World & world);
+
+// Function to handle alien laser firing, only the frontline alien of a column fires once its cooldown ran out
+void handleAlienLaserFiring(World & world);
+
+// Functions to find collisions, they only read the world and push events
+void findLaserMothershipCollision(const World & world, std::vector<GameEvent> & events);
+void findLaserAlienCollisions(const World & world, std::vector<GameEvent> & events);
+void findLaserShieldCollisions(const World & world, std::vector<GameEvent> & events);
+void findLaserPlayerCollisions(const World & world, std::vector<GameEvent> & events);
+
+// Function to apply the side effects of this tick's collisions: damage, kills, points, explosions and state changes
+void applyGameEvents(World & world);
+
+// Function to remove everything that died during the tick, called once at the end of the simulation step
+void removeDeadEntities(World & world);
+
+// Function to create a laser, aimed at the player from alienPosition if it is an alien's
+void createLaser(World & world, Laser & laser, const glm::vec3 & playerPosition, const glm::vec3 & startPos, bool player_shot, const glm::vec3 & alienPosition = glm::vec3(0.0f, 0.0f, 0.0f));
+
+// Function to sweep a laser's bounding box over its last step against a bounding box placed at position
+bool sweepLaserAgainst(const Laser & laser, const glm::vec3 & position, const Bounds & bounds, float & hitT);
+
+// Function to produce the controls of a simple bot: it chases the lowest alien and fires when roughly underneath it
+PlayerInput scriptedPlayerInput(const World & world);
+
+#endif
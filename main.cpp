@@ -1,9 +1,9 @@
 // Include necessary standard and external libraries
 #include <chrono>                   // For time-based functions
-#include <iostream>                 // Standard input/output stream for debugging/logging
-#include <map>                      // Map container from STL for key-value pairs
+#include <memory_resource>          // Polymorphic allocators for the per-level memory arena
 #include <stdio.h>                  // Standard input/output operations
 #include <stdlib.h>                 // Standard library functions
+#include <string>                   // Strings for command line parsing
 #include <thread> 				    // For thread-related functions
 #include <vector>                   // Vector container from the Standard Template Library (STL)
 
@@ -24,6 +24,24 @@ using namespace glm;
 #include "common/controls.hpp"      // Controls handling (e.g., keyboard and mouse input)
 #include "common/texture.hpp"       // Texture loading functions
 #include "common/text2D.hpp"        // Text rendering functions
+#include "common/levelfile.hpp"     // Level definitions loaded from the level file
+#include "common/collision.hpp"     // Bounding volumes and swept segment intersection tests
+#include "common/culling.hpp"       // View frustum culling of bounding spheres
+#include "common/backend.hpp"       // Window or offscreen rendering backend
+#include "common/imagecompare.hpp"  // Comparison of rendered frames against reference images
+#include "common/pngwrite.hpp"      // PNG output for frame dumps and reference images
+#include "common/gputimer.hpp"      // GPU time of each render pass
+#include "common/glhandles.hpp"     // Move-only owners of OpenGL buffers, vertex arrays and textures
+#include "common/memstats.hpp"      // Memory accounting by category
+#include "common/benchmark.hpp"     // Benchmark settings, measurements and JSON report
+#include "common/log.hpp"           // Leveled asynchronous logging
+#include "common/explosions.hpp"    // Explosions drawn as instances of one mesh
+#include "common/laserbatch.hpp"    // Lasers drawn as instances of one mesh
+#include "common/formation.hpp"     // Alien formation as grid slots around one moving origin
+#include "common/world.hpp"         // Game simulation: levels, entities, collisions and rules
+#include "common/snapshot.hpp"      // Binary copies of a world's state
+#include "common/input.hpp"         // Key events mapped to actions, recorded and replayed
+#include "common/framepacing.hpp"   // Swap interval, frame cap and input-to-present latency
 
 
 // Include TinyObjLoader for loading .obj 3D model files
@@ -34,11 +52,8 @@ using namespace glm;
 #define STB_IMAGE_IMPLEMENTATION
 #include "common/stb_image.h"              // Header for stb_image library used to load textures
 
-// Macro definitions for debugging purposes
-#define DEBUG true                  // Set to true to enable debug prints
-#define DEBUG_PRINT(msg) if (DEBUG) {std::cout << msg << std::endl;}  // Print the message if debugging is enabled
-#define DEBUG_LARGE false 		 // Set to true to enable large debug prints
-#define DEBUG_LARGE_PRINT(msg) if (DEBUG_LARGE) {std::cout << msg << std::endl;}  // Print the message if debugging is enabled
+// Logging goes through common/log: messages below LOG_MIN_LEVEL are compiled out, the rest are
+// written by a background thread so the game loop never waits on the console
 
 
 // Declare external variables
@@ -50,177 +65,137 @@ extern glm::mat4 ProjectionMatrix;   // Camera projection matrix (for perspectiv
 
 ///  Global Variables
 
-// General use
-float LEFTBOUNDARY = -50.0f;       // Left boundary of the movement area
-float RIGHTBOUNDARY = 50.0f;       // Right boundary of the movement area
-int nextObjectId = 0;              // A global counter to ensure each object has a unique identifier (ID)
-int playerPoints = 0;			 // Global variable to keep track of the player's points
-int HighScore = 0;				 // Global variable to keep track of the player's high score
-
-
-// Alien Related
-float alienSpeed = 0.02f;          // Speed at which aliens move horizontally
-bool alienMovingRight = true;      // Boolean flag to indicate the current direction of alien movement (right or left)
-float alienDropDistance = 0.5f;    // Distance that aliens move down when they hit a boundary
-int alien_laser_timer = 1; 		   // Timer for alien laser firing
-
-// MotherShip Related
-bool mothershipAlive = false;         // Flag to check if the mothership is still alive
-int mothershipHealth = 10;            // Variable to hold the health of the mothership, can be adjusted
-bool mothershipMovingRight = true;    // Direction flag for the mothership (moving right or left)
-const float mothershipSpeed = 0.05f;  // Speed at which the mothership moves horizontally
-int mothership_laser_timer = 5;       // Timer for mothership laser firing
-
-//Player Related
-const float PLAYER_SPEED = 20.0f;  // Speed at which the player can move
-double lastShotTime = 0.0f;        // Stores the time when the last shot was fired (for cooldown purposes)
-const float SHOT_COOLDOWN = 0.3f;  // Cooldown duration for shooting
-double lastHitTime = 0.0; // Stores the time when the player was last hit
-const float INVINCIBILITY_DURATION = 3.0f; // Duration of invincibility in seconds
-bool isInvincible = false; // Flag to indicate if the player is currently invincible
-bool isBlinking = false; // Flag to indicate if the player is currently blinking
-double nextBlinkTime = 0.0; // Time for the next blink
-const float BLINK_INTERVAL = 0.2f; // Interval between blinks in seconds
-
-
+// Gameplay state (score, lasers, mothership, invincibility, game state, ...) lives in the World, see common/world.hpp.
+// What is left here belongs to the renderer and the process.
 
 
 // Define the structure to hold the cached data for OBJ modles
 struct ObjCache
 {
+	bool loaded = false;                        // Whether the model was already loaded into this cache entry
 	std::vector<glm::vec3> vertices;            // Vertices of the object (positions of each point in space)
 	std::vector<glm::vec2> uvs;                 // Texture coordinates for the object's surfaces
 	std::vector<glm::vec3> normals;             // Normals for lighting calculations
 	std::vector<tinyobj::material_t> materials; // Material data (e.g., color, specular, etc.)
 	std::vector<std::string> textures;          // File paths to texture images
-	std::vector<GLuint> textureIDs;             // OpenGL texture IDs associated with the textures
+	std::vector<GLuint> textureIDs;             // OpenGL texture IDs associated with the textures, handed out to objects
+	std::vector<GLTexture> textureHandles;      // Owners of the textures, deleted when the entry is reset
+	Bounds bounds;                              // Bounding box and sphere of the mesh, computed when it is loaded
+
+	// Bytes of vertex data held on the CPU, accounted under MEM_MESH_CPU
+	size_t meshBytes() const
+	{
+		return vertices.capacity() * sizeof(glm::vec3) + uvs.capacity() * sizeof(glm::vec2) + normals.capacity() * sizeof(glm::vec3);
+	}
 };
 
 
-// Define the structure to represent each game object (such as player, alien, etc.)
+// Upstream of every level arena, accounts the memory of all entities
+CountingMemoryResource entityMemory(MEM_ENTITIES);
+
+
+
+// Define the structure holding the OpenGL resources of one model, every entity using the model is drawn with it
 struct GameObject
 {
-	std::string objFile;               // Path to the .obj file containing the 3D model
-	std::string mtlFile;               // Path to the material (.mtl) file associated with the model
-	std::vector<glm::vec3> vertices;   // Vertices of the object (positions in 3D space)
-	std::vector<glm::vec2> uvs;        // Texture coordinates
-	std::vector<glm::vec3> normals;    // Normal vectors used for lighting
-	std::vector<tinyobj::material_t> materials; // Material properties for rendering
-	std::vector<std::string> textures; // List of textures associated with the object
-	std::vector<GLuint> textureIDs;    // OpenGL texture IDs for the object
-	glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f); // Default position of the object
-	glm::mat4 modelMatrix = glm::mat4(1.0f);  // Default identity matrix for the model (no transformation by default)
-	GLuint vertexArrayID = 0;          // OpenGL Vertex Array Object (VAO) ID
-	GLuint vertexBuffer = 0;           // OpenGL Vertex Buffer Object (VBO) for vertices
-	GLuint uvBuffer = 0;               // OpenGL VBO for texture coordinates (UVs)
-	GLuint normalBuffer = 0;           // OpenGL VBO for normals
-	int id = -1;                       // Unique identifier for the object (default -1)
-	std::string type;                  // Type of the object (e.g., "alien", "player", etc.)
-
-	// Constructor to initialize the GameObject with default values
-	GameObject()
-		: position(glm::vec3(0.0f, 0.0f, 0.0f)),   // Default position at the origin
-		modelMatrix(glm::mat4(1.0f)),             // Default model matrix (identity matrix, no transformations)
-		vertexArrayID(0), vertexBuffer(0), uvBuffer(0), normalBuffer(0), id(-1) // Default to invalid or uninitialized OpenGL objects
-	{
-	}
+	ModelId model = MODEL_NONE;        // Model uploaded (see modelFiles)
+	GLsizei vertexCount = 0;           // Number of vertices drawn, the mesh data itself stays in the OBJ cache
+	std::vector<GLuint> textureIDs;    // OpenGL texture IDs of the model, owned by the OBJ cache
+	glm::mat4 modelMatrix = glm::mat4(1.0f); // Transformation of the entity being drawn, set before each draw
+	GLVertexArray vertexArray;         // OpenGL Vertex Array Object (VAO)
+	GLBuffer vertexBuffer;             // OpenGL Vertex Buffer Object (VBO) for vertices
+	GLBuffer uvBuffer;                 // OpenGL VBO for texture coordinates (UVs)
+	GLBuffer normalBuffer;             // OpenGL VBO for normals
+
+	// Objects own their OpenGL buffers, so they can be moved but never copied
+	GameObject() = default;
+	GameObject(const GameObject&) = delete;
+	GameObject& operator=(const GameObject&) = delete;
+	GameObject(GameObject&&) = default;
+	GameObject& operator=(GameObject&&) = default;
 };
 
 
-// Define the Laser structure, which represents a laser shot fired by the player or enemies
-struct Laser
-{
-	glm::vec3 direction = glm::vec3(0.0f, 1.0f, 0.0f); // Direction the laser moves in (default is upwards)
-	float speed = 10.0f;                               // Speed at which the laser moves
-	bool active = false;                               // Whether the laser is active and should be rendered or not
-	bool player_friendly = true;                       // To specify if they are player (true) or alien frindly(false)
 
-	GameObject obj;                                   // The laser itself is also a GameObject, allowing it to have geometry and a model
-};
+// Declare a cache to store parsed OBJ file data to avoid reloading the same file multiple times, indexed by ModelId
+ObjCache objCache[MODEL_COUNT];
 
+// Drawable of every model drawn as a plain object (player, aliens, mothership, shield), uploaded once by loadModels
+GameObject modelObjects[MODEL_COUNT];
 
-// Define the game state to represent the current state of the game
-enum GameState {
-	GAME_START,
-	GAME_PLAYING,
-	GAME_PAUSED,
-	GAME_OVER,
-	NEW_LEVEL,
-	NEW_LEVEL_START,
-	GAME_RESET
-};
+// Bounding volumes of every model, handed to each World and never written once loaded
+Bounds modelBounds[MODEL_COUNT];
 
+// Instance records of the lasers drawn this frame, reused every frame so its storage is only allocated once
+std::vector<LaserInstance> laserInstances;
 
-// Define the structure to represent a shield object
-struct Shield
+// Define the objects gathered for rendering in one frame, bounding spheres are stored per component for batch culling
+struct RenderBatch
 {
-	GameObject obj;      // The shield itself is also a GameObject
-	int health = 10;     // Health of the shield
-
+	std::vector<GameObject*> objects;  // Objects that would be drawn this frame
+	std::vector<glm::vec3> positions;  // Where each one is drawn, entities share one object per model
+	std::vector<float> scales;         // Scale each one is drawn with
+	std::vector<float> x, y, z;        // World space centers of their bounding spheres
+	std::vector<float> radius;         // Radii of their bounding spheres
+	std::vector<unsigned char> visible; // Culling result, 1 if the object is inside the view frustum
 };
 
-
-// Define the structure to represent an explosion object
-struct Explosion
+// Define the culling results of the last rendered frame
+struct CullStats
 {
-	GameObject obj;       // The explosion itself is also a GameObject
-	double spawnTime = 0.0;     // Time when the explosion was spawned
-	bool active = true;   // Whether the explosion is active or not
+	int drawn = 0;   // Objects submitted for drawing
+	int culled = 0;  // Objects rejected by frustum culling
 };
 
+// Render batch reused every frame so its storage is only allocated once
+RenderBatch renderBatch;
+
+// Culling results of the last frame
+CullStats cullStats;
 
+// Whether the statistics overlay is shown (toggled with F3)
+bool showStats = false;
 
-// Declare a cache to store parsed OBJ file data to avoid reloading the same file multiple times
-std::map<std::string, ObjCache> objCache;
+// Draw calls issued for game objects this frame, reported by benchmark runs
+int drawCalls = 0;
 
-// Vector containing all active lasers (both player and enemy lasers)
-std::vector<Laser> lasers;
 
-// Vector containing all active explosions
-std::vector<Explosion> explosions;
+// Scenes rendered by the golden-frame harness (--golden / --golden-update)
+enum GoldenScene
+{
+	GOLDEN_START_MENU,   // Start screen text only
+	GOLDEN_ALIEN_GRID,   // First level with the full alien grid
+	GOLDEN_MID_BATTLE,   // First level with aliens destroyed, explosions and lasers in flight
+	GOLDEN_SCENE_COUNT
+};
 
-// Initially, the game starts in the start state
-GameState currentState = GAME_START;
+const int GOLDEN_PIXEL_TOLERANCE = 16;               // Per channel difference allowed before a pixel counts as different
+const double GOLDEN_MAX_DIFFERING_FRACTION = 0.005;  // Fraction of differing pixels allowed for a scene to pass
 
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
 // Function prototypes
 
 // Function to load textures and cache them to avoid reloading the same texture multiple times
-GLuint loadTexture(const std::string& texturePath);
+GLTexture loadTexture(const std::string& texturePath);
 
-// Function to load the OBJ file and its associated materials
-bool OBJloadingfunction(const char* objpath, const char* mtlpath,
-	std::vector<glm::vec3>& out_vertices,
-	std::vector<glm::vec2>& out_uvs,
-	std::vector<glm::vec3>& out_normals,
-	std::vector<tinyobj::material_t>& out_materials,
-	std::vector<std::string>& out_textures,
-	std::vector<GLuint>& out_textureIDs);
+// Function to load the OBJ file and its associated materials into the OBJ cache
+bool OBJloadingfunction(ModelId model);
 
 // Function to load game object data and initialize buffers
 void loadGameObject(GameObject& obj);
 
-// Function to generate unique IDs for game objects
-int generateUniqueID();
-
-// Function to load the player ship
-void createPlayer(GameObject& playerShip);
+// Function to upload every model drawn as a plain object once and record the bounds of every model
+bool loadModels();
 
-// Function to create a shield
-Shield createShield(const glm::vec3& position, int health);
+// Function to empty the OBJ cache
+void clearObjCache();
 
-// Function to create an explosion at a specific position
-void createExplosion(Explosion& explosion, const glm::vec3& position);
+// Function to load the explosion mesh and texture into the explosion particle system
+bool loadExplosions();
 
-// Function to load the mothership
-void createMothership(GameObject& motherShip, int motherShipHealth);
-
-// Function to create a laser
-void createLaser(Laser& laser, const glm::vec3& playerPosition, const glm::vec3& startPos, bool player_shot, const glm::vec3& alienPosition = glm::vec3(0.0f, 0.0f, 0.0f));
-
-// Function to create aliens dynamically with flexibility
-void createAliens(std::vector<GameObject>& aliens_vector, int rows, int cols, float spacing = 5.0f, const glm::vec3& startPos = glm::vec3(0.0f, 25.0f, 0.0f));
+// Function to load the laser mesh and texture into the laser batch
+bool loadLasers();
 
 // Function to render any game object
 void renderObject(const GameObject& obj, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID, const glm::mat4& ProjectionMatrix, const glm::mat4& ViewMatrix, float scale = 1.0f);
@@ -228,192 +203,54 @@ void renderObject(const GameObject& obj, GLuint MatrixID, GLuint ModelMatrixID,
 // Function to clean up OpenGL resources for a GameObject
 void cleanupGameObject(GameObject& obj);
 
-// General cleanup function to clear all resources
-void effectclean(std::vector<Explosion> explosions, std::vector<Laser> lasers);
-
-// Function to handle player movement based on user input
-void handlePlayerMovement(GameObject& player, float deltaTime);
-
-// Function to update the positions of aliens
-void updateAlienPositions(std::vector<GameObject>& aliens_vector);
-
-// Function to update the mothership's position
-void updateMothershipPosition(GameObject& motherShip);
-
-// Function to update laser position
-void updateLaser(Laser& laser, float deltaTime);
-
-// Function to render a laser if it is active
-void renderLaser(Laser& laser, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID, const glm::mat4& ProjectionMatrix, const glm::mat4& ViewMatrix);
-
-// Function to check if a laser collides with an alien
-bool checkLaserAlienCollision(const Laser& laser, GameObject& alien);
+// Function to start a level of the world and drop what the renderer kept of the previous one
+void loadWorldLevel(World& world, int number);
 
-// Function to handle collisions between lasers and aliens
-void handleLaserAlienCollisions(std::vector<GameObject>& aliens, std::vector<Explosion>& explosions);
-
-// Function to check if a laser collides with the mothership
-bool checkLaserMothershipCollision(const Laser& laser, GameObject& motherShip);
-
-// Function to handle laser collisions with the mothership
-void handleLaserMothershipCollision(GameObject& mothership, std::vector<Explosion>& explosions);
-
-// Function to handle alien laser firing
-void handleAlienLaserFiring(std::vector<GameObject>& aliens_vector, const glm::vec3& playerPosition, int value, GameObject& player);
-
-// Function to handle mothership laser firing
-void handleMothershipLaserFiring(GameObject& motherShip, int value, GameObject& player);
-
-// Function to check if a laser collides with a shield
-bool checkLaserShieldCollision(const Laser& laser, Shield& shield);
-
-// Function to handle collisions between lasers and shields
-void handleLaserShieldCollisions(std::vector<Shield>& shields);
-
-// Function to check if a laser collides with the player
-bool checkLaserPlayerCollision(const Laser& laser, GameObject& player);
-
-// Function to handle collisions between lasers and the player
-int handleLaserPlayerCollisions(GameObject& player, int playerHealth);
+// Function to read the player's controls from the keyboard
+PlayerInput readPlayerInput();
 
 // Function to handle game states and transitions
-void handleGameStates();
-
-// Function to update explosions
-void updateExplosions(std::vector<Explosion>& explosions);
-
-// Function to render explosions
-void renderExplosions(Explosion& explosion, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID, const glm::mat4& ProjectionMatrix, const glm::mat4& ViewMatrix);
-
-
-
-//-------------------------------------------------------------------------------------------------
-//-------------------------------------------------------------------------------------------------
-// Define the Level class to encapsulate level-specific logic
-class Level {
-public:
-	std::vector<GameObject> aliens;
-	std::vector<Shield> shields;
-	GameObject playerShip;
-	GameObject motherShip;
-	int playerHealth;
-	int rowAliens;
-	int colAliens;
-	int shieldHealth;
-	float alienSpeed;
-	int motherShipHealth;
-
-
-	Level(int rowAliens, int colAliens, int shieldHealth, int playerHealth, float alienSpeed, int motherShipHealth)
-		: rowAliens(rowAliens), colAliens(colAliens), shieldHealth(shieldHealth), playerHealth(playerHealth), alienSpeed(alienSpeed), motherShipHealth(motherShipHealth) {
-	}
-
-	void initialize() {
-		createPlayer(playerShip);
-		createMothership(motherShip, motherShipHealth);
-		createShields();
-		createAliens(aliens, rowAliens, colAliens);
-
-	}
-
-	void createShields() {
-		shields.push_back(createShield(glm::vec3(-30.0f, -20.0f, 0.0f), shieldHealth));
-		shields.push_back(createShield(glm::vec3(0.0f, -20.0f, 0.0f), shieldHealth));
-		shields.push_back(createShield(glm::vec3(30.0f, -20.0f, 0.0f), shieldHealth));
-	}
-
-	void cleanuplevel() {
-		cleanupGameObject(playerShip);
-		if (mothershipAlive) {
-			cleanupGameObject(motherShip);
-		}
-		for (auto& alien : aliens) {
-			cleanupGameObject(alien);
-		}
-		aliens.clear();
-		for (auto& shield : shields) {
-			cleanupGameObject(shield.obj);
-		}
-		shields.clear();
-		effectclean(explosions, lasers);
-		objCache.clear();
-		DEBUG_PRINT("Level Cleanup complete!");
-
-	}
-};
-
-
-//-------------------------------------------------------------------------------------------------
-// Define the LevelManager class to manage levels
-class LevelManager {
-public:
-	Level* currentLevel;
-	int currentLevelNumber;
-
-	LevelManager() : currentLevel(nullptr), currentLevelNumber(0) {}
-
-	~LevelManager() {
-		if (currentLevel) {
-			currentLevel->cleanuplevel();
-			delete currentLevel;
-		}
-	}
-
-	void startNextLevel() {
-
-		if (currentLevel) {
-			currentLevel->cleanuplevel();
-			delete currentLevel;
-		}
+void handleGameStates(World& world);
 
+// Function to add a model drawn at a position and scale to this frame's render batch, bounds are the model's at that scale
+void addToRenderBatch(ModelId model, const glm::vec3& position, float scale, const Bounds& bounds);
 
-		currentLevelNumber++;
-		int rowAliens = 3 + currentLevelNumber; // Increase the number of rows with each level
-		int colAliens = 3 + currentLevelNumber; // Increase the number of columns with each level
-		int shieldHealth = 10 + (currentLevelNumber * 5); // Increase shield health with each level
-		float alienSpeed = 0.01f + (currentLevelNumber * 0.01f); // Increase alien speed with each level
-		int playerHealth = 3; // Reset player health for each level
-		int motherShipHealth = 5 + (currentLevelNumber * 5); // Increase mothership health with each level
+// Function to render every visible object of the world, culling against the camera frustum first
+void renderScene(const World& world, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID, const glm::mat4& ProjectionMatrix, const glm::mat4& ViewMatrix);
 
-		currentLevel = new Level(rowAliens, colAliens, shieldHealth, playerHealth, alienSpeed, motherShipHealth);
-		currentLevel->initialize();
-	}
+// Function to draw the start screen text
+void renderStartScreen();
 
-	void resetLevel() {
-		if (currentLevel) {
-			currentLevel->cleanuplevel();
-			delete currentLevel;
-			currentLevel = nullptr; // Ensure the pointer is set to nullptr after deletion
+// Function to draw the lives, points and statistics overlay while playing
+void renderHUD(const World& world);
 
-		}
+// Function to render the golden scenes and compare them against (or record) reference images
+int runGoldenFrames(World& world, const char* directory, bool update, GLuint programID, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID);
 
-		currentLevelNumber = 0;
-		startNextLevel();
-	}
-};
+// Function to time the formation update of alienCount aliens: per object, bulk kernels and formation origin
+void runFormationBenchmark(int alienCount);
 
 
 //-------------------------------------------------------------------------------------------------
 // Function to load textures and cache them to avoid reloading the same texture multiple times
-GLuint loadTexture(const std::string& texturePath)
+GLTexture loadTexture(const std::string& texturePath)
 {
 	int width, height, channels;
 	// Print debug message with texture path
-	DEBUG_PRINT("Attempting to load texture from: " << texturePath);
+	LOG_DEBUG("Attempting to load texture from: %s", texturePath.c_str());
 
 	// Load the texture data from the specified file path
 	unsigned char* data = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
 	if (!data) // Check if texture loading failed
 	{
 		// Print debug message with error details
-		DEBUG_PRINT("Failed to load texture: " << texturePath);
-		DEBUG_PRINT("stbi_error: " << stbi_failure_reason());
-		return 0; // Return 0 (invalid texture) in case of failure
+		LOG_WARN("Failed to load texture: %s (stbi_error: %s)", texturePath.c_str(), stbi_failure_reason());
+		return GLTexture(); // Return an empty texture in case of failure
 	}
 
-	GLuint textureID;
-	glGenTextures(1, &textureID); // Generate a texture ID
-	glBindTexture(GL_TEXTURE_2D, textureID); // Bind the texture to the 2D texture target
+	GLTexture texture;
+	texture.create(); // Generate a texture ID
+	glBindTexture(GL_TEXTURE_2D, texture.get()); // Bind the texture to the 2D texture target
 
 	// Set texture parameters (wrapping and filtering modes)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT); // Wrap the texture in the S direction
@@ -434,36 +271,25 @@ GLuint loadTexture(const std::string& texturePath)
 	glGenerateMipmap(GL_TEXTURE_2D); // Generate mipmaps for the texture
 	stbi_image_free(data); // Free the loaded image data from memory
 
+	// Account the texture, the mipmap chain adds a third to the base level
+	texture.track(MEM_TEXTURES, static_cast<size_t>(width) * height * channels * 4 / 3);
+
 	// Print debug message indicating texture load success
-	DEBUG_PRINT("Successfully loaded texture: " << texturePath);
-	return textureID; // Return the texture ID
+	LOG_DEBUG("Successfully loaded texture: %s", texturePath.c_str());
+	return texture; // Return the texture
 }
 
 
 //-------------------------------------------------------------------------------------------------
 // Function to load the OBJ file and its associated materials
 // Caches data to avoid reloading the same object multiple times
-bool OBJloadingfunction(const char* objpath, const char* mtlpath,
-	std::vector<glm::vec3>& out_vertices,
-	std::vector<glm::vec2>& out_uvs,
-	std::vector<glm::vec3>& out_normals,
-	std::vector<tinyobj::material_t>& out_materials,
-	std::vector<std::string>& out_textures,
-	std::vector<GLuint>& out_textureIDs)
+bool OBJloadingfunction(ModelId model)
 {
-	// Check if the OBJ file is already in the cache
-	auto it = objCache.find(objpath);
-	if (it != objCache.end()) // If cached data exists, use it
+	// Nothing to do if the OBJ file is already in the cache
+	ObjCache& cache = objCache[model];
+	if (cache.loaded)
 	{
-		// Retrieve cached data and assign it to output variables
-		const ObjCache& cache = it->second;
-		out_vertices = cache.vertices;
-		out_uvs = cache.uvs;
-		out_normals = cache.normals;
-		out_materials = cache.materials;
-		out_textures = cache.textures;
-		out_textureIDs = cache.textureIDs;
-		return true; // Return true since data is fetched from cache
+		return true;
 	}
 
 	// Proceed with loading the OBJ file if not cached
@@ -471,23 +297,25 @@ bool OBJloadingfunction(const char* objpath, const char* mtlpath,
 	std::vector<tinyobj::shape_t> shapes; // Stores shapes from the OBJ file
 	std::vector<tinyobj::material_t> materials; // Stores material properties (color, texture)
 	std::string warn, err; // To hold warning and error messages during the load process
+	const char* objpath = modelFiles[model].objFile; // Path of the model's OBJ file
+	const char* mtlpath = modelFiles[model].mtlFile; // Folder of the model's materials
 
-	DEBUG_PRINT("Loading OBJ file: " << objpath);
+	LOG_DEBUG("Loading OBJ file: %s", objpath);
 
 	// Load the OBJ file and materials using TinyOBJ loader
 	bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objpath, mtlpath);
 	if (!warn.empty()) // Print warnings if any
 	{
-		std::cerr << "Warning: " << warn << std::endl;
+		LOG_WARN("Warning: %s", warn.c_str());
 	}
 	if (!err.empty()) // Print errors if any
 	{
-		std::cerr << "Error: " << err << std::endl;
+		LOG_ERROR("Error: %s", err.c_str());
 		return false; // Return false if loading fails
 	}
 
-	// Store materials for later use
-	out_materials = materials;
+	// Store materials in the cache
+	cache.materials = materials;
 
 	// Get the folder path for the materials to load textures correctly
 	std::string mtlFolderPath = std::string(mtlpath);
@@ -503,26 +331,27 @@ bool OBJloadingfunction(const char* objpath, const char* mtlpath,
 		if (!material.diffuse_texname.empty()) // If a texture is specified
 		{
 			std::string fullTexturePath = mtlFolderPath + "/" + material.diffuse_texname; // Create full texture path
-			out_textures.push_back(fullTexturePath); // Store texture path
-			DEBUG_PRINT("Found texture: " << fullTexturePath);
+			cache.textures.push_back(fullTexturePath); // Store texture path
+			LOG_DEBUG("Found texture: %s", fullTexturePath.c_str());
 		}
 		else
 		{
-			out_textures.push_back(""); // No texture, store an empty string
+			cache.textures.push_back(""); // No texture, store an empty string
 		}
 	}
 
 	// Load textures for each material (if available)
-	for (const auto& texturePath : out_textures)
+	for (const auto& texturePath : cache.textures)
 	{
 		if (!texturePath.empty()) // If texture path is not empty
 		{
-			GLuint textureID = loadTexture(texturePath); // Load the texture
-			out_textureIDs.push_back(textureID); // Store the texture ID
+			GLTexture texture = loadTexture(texturePath); // Load the texture
+			cache.textureIDs.push_back(texture.get()); // Store the texture ID
+			cache.textureHandles.push_back(std::move(texture)); // The cache owns the texture from now on
 		}
 		else
 		{
-			out_textureIDs.push_back(0); // No texture, store 0 (invalid texture)
+			cache.textureIDs.push_back(0); // No texture, store 0 (invalid texture)
 		}
 	}
 
@@ -539,7 +368,7 @@ bool OBJloadingfunction(const char* objpath, const char* mtlpath,
 			vertex.x = attrib.vertices[3 * index.vertex_index + 0];
 			vertex.y = attrib.vertices[3 * index.vertex_index + 1];
 			vertex.z = attrib.vertices[3 * index.vertex_index + 2];
-			out_vertices.push_back(vertex); // Store vertex position
+			cache.vertices.push_back(vertex); // Store vertex position
 
 			// Extract normal vector (if available) and store it
 			if (index.normal_index >= 0)
@@ -547,7 +376,7 @@ bool OBJloadingfunction(const char* objpath, const char* mtlpath,
 				normal.x = attrib.normals[3 * index.normal_index + 0];
 				normal.y = attrib.normals[3 * index.normal_index + 1];
 				normal.z = attrib.normals[3 * index.normal_index + 2];
-				out_normals.push_back(normal);
+				cache.normals.push_back(normal);
 			}
 
 			// Extract texture coordinates (if available) and store them
@@ -555,23 +384,19 @@ bool OBJloadingfunction(const char* objpath, const char* mtlpath,
 			{
 				uv.x = attrib.texcoords[2 * index.texcoord_index + 0];
 				uv.y = attrib.texcoords[2 * index.texcoord_index + 1];
-				out_uvs.push_back(uv);
+				cache.uvs.push_back(uv);
 			}
 		}
 	}
 
-	// Cache the loaded data for future use
-	ObjCache cache;
-	cache.vertices = out_vertices;
-	cache.uvs = out_uvs;
-	cache.normals = out_normals;
-	cache.materials = out_materials;
-	cache.textures = out_textures;
-	cache.textureIDs = out_textureIDs;
-	objCache[objpath] = cache; // Store the data in the cache
+	// Compute the bounding volumes once per model
+	cache.bounds = computeBounds(cache.vertices);
+
+	cache.loaded = true;
+	memAdd(MEM_MESH_CPU, cache.meshBytes());
 
 	// Print success message and return true
-	DEBUG_PRINT("OBJ file loaded successfully!");
+	LOG_DEBUG("OBJ file loaded successfully!");
 	return true;
 }
 
@@ -581,36 +406,47 @@ bool OBJloadingfunction(const char* objpath, const char* mtlpath,
 void loadGameObject(GameObject& obj)
 {
 	// Print the file being loaded to the debug log
-	DEBUG_LARGE_PRINT("Loading GameObject: " << obj.objFile);
+	LOG_TRACE("Loading GameObject: %s", modelFiles[obj.model].objFile);
 
 	// Attempt to load the object file and its materials, if loading fails, print error
-	if (!OBJloadingfunction(obj.objFile.c_str(), obj.mtlFile.c_str(), obj.vertices, obj.uvs, obj.normals, obj.materials, obj.textures, obj.textureIDs))
+	if (!OBJloadingfunction(obj.model))
 	{
-		DEBUG_PRINT("Failed to load GameObject: " << obj.objFile);
+		LOG_ERROR("Failed to load GameObject: %s", modelFiles[obj.model].objFile);
 		return; // Return early if loading fails
 	}
 
+	// The object keeps only what it needs to draw itself, the mesh data is read from the cache
+	const ObjCache& cache = objCache[obj.model];
+	obj.vertexCount = static_cast<GLsizei>(cache.vertices.size());
+	obj.textureIDs.assign(cache.textureIDs.begin(), cache.textureIDs.end());
+
+	// The simulation collides with the model's bounding volumes, entities scale them themselves
+	modelBounds[obj.model] = cache.bounds;
+
 	// Generate a new Vertex Array Object (VAO) for the game object to store vertex attributes
-	glGenVertexArrays(1, &obj.vertexArrayID);
-	glBindVertexArray(obj.vertexArrayID);
+	obj.vertexArray.create();
+	glBindVertexArray(obj.vertexArray.get());
 
 	// Create and bind a Vertex Buffer Object (VBO) for the vertex data (positions)
-	glGenBuffers(1, &obj.vertexBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, obj.vertexBuffer);
+	obj.vertexBuffer.create();
+	glBindBuffer(GL_ARRAY_BUFFER, obj.vertexBuffer.get());
 	// Fill the buffer with the vertex data (positions) from the object
-	glBufferData(GL_ARRAY_BUFFER, obj.vertices.size() * sizeof(glm::vec3), &obj.vertices[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, cache.vertices.size() * sizeof(glm::vec3), &cache.vertices[0], GL_STATIC_DRAW);
+	obj.vertexBuffer.track(MEM_MESH_GPU, cache.vertices.size() * sizeof(glm::vec3));
 
 	// Create and bind a VBO for the UV texture coordinates data
-	glGenBuffers(1, &obj.uvBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, obj.uvBuffer);
+	obj.uvBuffer.create();
+	glBindBuffer(GL_ARRAY_BUFFER, obj.uvBuffer.get());
 	// Fill the UV buffer with the texture coordinates from the object
-	glBufferData(GL_ARRAY_BUFFER, obj.uvs.size() * sizeof(glm::vec2), &obj.uvs[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, cache.uvs.size() * sizeof(glm::vec2), &cache.uvs[0], GL_STATIC_DRAW);
+	obj.uvBuffer.track(MEM_MESH_GPU, cache.uvs.size() * sizeof(glm::vec2));
 
 	// Create and bind a VBO for the normal vector data
-	glGenBuffers(1, &obj.normalBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, obj.normalBuffer);
+	obj.normalBuffer.create();
+	glBindBuffer(GL_ARRAY_BUFFER, obj.normalBuffer.get());
 	// Fill the normal buffer with the normal vectors from the object
-	glBufferData(GL_ARRAY_BUFFER, obj.normals.size() * sizeof(glm::vec3), &obj.normals[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, cache.normals.size() * sizeof(glm::vec3), &cache.normals[0], GL_STATIC_DRAW);
+	obj.normalBuffer.track(MEM_MESH_GPU, cache.normals.size() * sizeof(glm::vec3));
 
 	// Iterate over the texture IDs and bind each texture if it's valid (non-zero ID)
 	for (GLuint textureID : obj.textureIDs)
@@ -625,224 +461,57 @@ void loadGameObject(GameObject& obj)
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to generate unique IDs for game objects
-int generateUniqueID()
-{
-	// Increment and return the next available unique object ID
-	return nextObjectId++;
-}
-
-
-//-------------------------------------------------------------------------------------------------
-// Function to load the player ship
-void createPlayer(GameObject& playerShip)
-{
-	// Log the creation process of the player
-	DEBUG_PRINT("Creating player...");
-
-	// Set the player's object file and material file for loading
-	playerShip.objFile = "obj/player.obj";
-	playerShip.mtlFile = "obj";  // Same texture folder as other objects
-
-	// Set the player's initial position in the game world
-	playerShip.position = glm::vec3(0.0f, -35.0f, 0.0f); // Position the player lower in the scene
-
-	// Generate a unique ID for the player
-	playerShip.id = generateUniqueID();
-
-	// Set the player type to "Player"
-	playerShip.type = "Player";
-
-	// Load the player object data
-	loadGameObject(playerShip);
-
-	// Log the successful creation of the player with its unique ID
-	DEBUG_PRINT("Player created!");
-}
-
-
-//-------------------------------------------------------------------------------------------------
-Shield createShield(const glm::vec3& position, int health)
-{
-	Shield shield;
-
-	// Set the shield's object file and material file for loading
-	shield.obj.objFile = "obj/shield.obj";
-	shield.obj.mtlFile = "obj"; // Same texture folder as other objects
-
-	// Set the shield's initial position in the game world
-	shield.obj.position = position;
-
-	// Generate a unique ID for the shield
-	shield.obj.id = generateUniqueID();
-
-	// Set the shield type to "Shield"
-	shield.obj.type = "Shield";
-
-	// Set the shield's initial health
-	shield.health = health; // Example health value
-
-	// Load the shield object data
-	loadGameObject(shield.obj);
-
-	// Log the successful creation of the shield with its unique ID
-	DEBUG_PRINT("Shield created!");
-
-	return shield;
-}
-
-
-//-------------------------------------------------------------------------------------------------
-// Function to create an explosion at a specific position
-void createExplosion(Explosion& explosion, const glm::vec3& position)
-{
-	// Set the explosion's object file and material file for loading
-	explosion.obj.objFile = "obj/explosion.obj";
-	explosion.obj.mtlFile = "obj"; // Same texture folder as other objects
-
-	// Set the explosion's initial position in the game world
-	explosion.obj.position = position;
-
-	// Generate a unique ID for the explosion
-	explosion.obj.id = generateUniqueID();
-
-	// Set the explosion type to "Explosion"
-	explosion.obj.type = "Explosion";
-
-	// Load the explosion object data
-	loadGameObject(explosion.obj);
-
-	// Set the spawn time to the current time
-	explosion.spawnTime = glfwGetTime();
-
-
-}
-
-
-//-------------------------------------------------------------------------------------------------
-// Function to load the mothership
-void createMothership(GameObject& motherShip, int motherShipHealth)
+// Function to upload every model drawn as a plain object once and record the bounds of every model
+bool loadModels()
 {
-	// Log the creation process of the mothership
-	DEBUG_PRINT("Creating mothership...");
-
-	// Set the mothership's object and material file
-	motherShip.objFile = "obj/mothership.obj";
-	motherShip.mtlFile = "obj"; // Assuming same texture folder as other objects
-
-	// Set the mothership's initial position in the game world
-	motherShip.position = glm::vec3(0.0f, 30.0f, 0.0f);
-
-	// Generate a unique ID for the mothership
-	motherShip.id = generateUniqueID();
-
-	// Set the mothership type to "MotherShip"
-	motherShip.type = "MotherShip";
-
-	// Set the mothership's initial state to alive when the game starts
-	mothershipAlive = true;
-
-	// Set initial health value (this can be adjusted later)
-	mothershipHealth = motherShipHealth;
-
-	// Load the mothership object data
-	loadGameObject(motherShip);
-
-	// Log the successful creation of the mothership with its unique ID
-	DEBUG_PRINT("Mothership created with health: " << mothershipHealth);
+	// Every entity of a model is drawn with the same buffers, so each model is uploaded once for the whole run
+	static const ModelId drawnModels[] = { MODEL_PLAYER, MODEL_ALIEN1, MODEL_ALIEN2, MODEL_ALIEN3, MODEL_MOTHERSHIP, MODEL_SHIELD };
+	bool loaded = true;
+	for (ModelId model : drawnModels)
+	{
+		modelObjects[model].model = model;
+		loadGameObject(modelObjects[model]);
+		loaded = loaded && modelObjects[model].vertexCount > 0;
+	}
+	return loaded;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to create a laser
-void createLaser(Laser& laser, const glm::vec3& playerPosition, const glm::vec3& startPos, bool player_shot, const glm::vec3& alienPosition)
+// Function to empty the OBJ cache
+void clearObjCache()
 {
-	// Set the laser's position in the game world (starts from the player's ship)
-	laser.obj.position = startPos;
-
-	// Set the laser's object file and material file for loading
-	laser.obj.objFile = "obj/laser.obj";
-	laser.obj.mtlFile = "obj"; // Same texture folder as other objects
-
-	laser.obj.id = generateUniqueID(); // Generate a unique ID for the laser
-
-	if (player_shot == true)
-	{
-		laser.player_friendly = true; // Set as Player Ally
-		laser.obj.type = "Player Laser"; // Set the object type as " Player Laser"
-		laser.direction = glm::vec3(0.0f, 1.0f, 0.0f); // Laser moves upwards
-	}
-	else if (player_shot == false)
+	for (ObjCache& cache : objCache)
 	{
-		laser.player_friendly = false; // Set as Player Enemy
-		laser.obj.type = "Enemy Laser"; // Set the object type as "Alien Laser"
-
-		if (alienPosition != glm::vec3(0.0f, 0.0f, 0.0f))
-		{
-			// Calculate the direction from the alien to the player if alien position is provided
-			glm::vec3 directionToPlayer = playerPosition - alienPosition; // Vector from alien to player
-			laser.direction = glm::normalize(directionToPlayer); // Normalize the vector to get direction
-		}
-		else
-		{
-			// Default direction if no alien position is provided (e.g., laser fired from player)
-			laser.direction = glm::vec3(0.0f, -1.0f, 0.0f); // Move upwards by default
-		}
-
+		memRemove(MEM_MESH_CPU, cache.meshBytes());
+		cache = ObjCache(); // Reset the entry so the model is parsed again on next use, this deletes its textures
 	}
-
-	// Load the laser object data
-	loadGameObject(laser.obj);
-
-	// Set the laser's active state to true, meaning it's ready for use
-	laser.active = true;
-
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to create aliens dynamically with flexibility
-void createAliens(std::vector<GameObject>& aliens_vector, int rows, int cols, float spacing, const glm::vec3& startPos)
+// Function to load the explosion mesh and texture into the explosion particle system
+bool loadExplosions()
 {
-	// Define an array of alien models to be assigned dynamically to aliens
-	std::vector<std::string> alienModels = { "obj/alien1.obj", "obj/alien2.obj", "obj/alien3.obj" };
-	DEBUG_PRINT("Creating aliens.");
-
-	// Loop through the rows and columns to create aliens dynamically
-	for (int row = 0; row < rows; ++row)
+	if (!OBJloadingfunction(MODEL_EXPLOSION))
 	{
-		for (int col = 0; col < cols; ++col)
-		{
-			// Create a new GameObject instance for each alien
-			GameObject alien;
-
-			// Assign an alien model based on the current row, cycling through models
-			alien.objFile = alienModels[row % alienModels.size()];
-			alien.mtlFile = "obj/"; // Assuming all aliens share the same material folder
-			alien.type = "Alien";    // Set the object type as "Alien"
-
-			// Position the alien in a grid formation, adjusting for spacing and start position
-			alien.position = startPos + glm::vec3(col * spacing, -row * spacing, 0.0f);
-
-			// Generate a unique ID for each alien
-			alien.id = generateUniqueID();
-
-			// Load the alien's object data
-			loadGameObject(alien);
-
-			// Add the newly created alien to the aliens vector
-			aliens_vector.push_back(alien);
-		}
+		LOG_ERROR("Failed to load the explosion model: %s", modelFiles[MODEL_EXPLOSION].objFile);
+		return false;
 	}
 
-	// Log how many aliens were created
-	DEBUG_PRINT("Created: " << aliens_vector.size() << " Aliens!");
+	// The particle system takes the texture and uploads its own copy of the mesh
+	ObjCache& cache = objCache[MODEL_EXPLOSION];
+	modelBounds[MODEL_EXPLOSION] = cache.bounds;
+	GLTexture texture = cache.textureHandles.empty() ? GLTexture() : std::move(cache.textureHandles[0]);
+	bool loaded = initExplosions(cache.vertices, cache.uvs, cache.normals, std::move(texture));
 
+	// Nothing else draws the model, so its cache entry is emptied right away
+	memRemove(MEM_MESH_CPU, cache.meshBytes());
+	cache = ObjCache();
+	return loaded;
 }
 
 
-
-
 //-------------------------------------------------------------------------------------------------
 // Function to render any game object
 void renderObject(const GameObject& obj, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID, const glm::mat4& ProjectionMatrix, const glm::mat4& ViewMatrix, float scale)
@@ -861,7 +530,7 @@ void renderObject(const GameObject& obj, GLuint MatrixID, GLuint ModelMatrixID,
 	glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &ViewMatrix[0][0]);
 
 	// Bind textures associated with the object
-	for (size_t i = 0; i < obj.textures.size(); i++)
+	for (size_t i = 0; i < obj.textureIDs.size(); i++)
 	{
 		GLuint texID = obj.textureIDs[i];
 		if (texID != 0) // Only bind if the texture ID is valid
@@ -876,25 +545,26 @@ void renderObject(const GameObject& obj, GLuint MatrixID, GLuint ModelMatrixID,
 	}
 
 	// Bind the Vertex Array Object (VAO) to prepare for rendering
-	glBindVertexArray(obj.vertexArrayID);
+	glBindVertexArray(obj.vertexArray.get());
 
 	// Enable and configure the vertex attribute for positions
 	glEnableVertexAttribArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, obj.vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, obj.vertexBuffer.get());
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
 
 	// Enable and configure the vertex attribute for texture coordinates (UVs)
 	glEnableVertexAttribArray(1);
-	glBindBuffer(GL_ARRAY_BUFFER, obj.uvBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, obj.uvBuffer.get());
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
 
 	// Enable and configure the vertex attribute for normals
 	glEnableVertexAttribArray(2);
-	glBindBuffer(GL_ARRAY_BUFFER, obj.normalBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, obj.normalBuffer.get());
 	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
 
 	// Draw the object using the vertex array
-	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(obj.vertices.size()));
+	glDrawArrays(GL_TRIANGLES, 0, obj.vertexCount);
+	drawCalls++;
 
 	// Disable the vertex attribute arrays after rendering
 	glDisableVertexAttribArray(0);
@@ -910,679 +580,676 @@ void renderObject(const GameObject& obj, GLuint MatrixID, GLuint ModelMatrixID,
 // Function to clean up OpenGL resources for a GameObject
 void cleanupGameObject(GameObject& obj)
 {
-	// Log the cleanup process of the GameObject with its ID and type
-	DEBUG_LARGE_PRINT("Cleaning up GameObject With ID = " << obj.id << " and Type = " << obj.type);
+	// Log the cleanup process of the GameObject with its model
+	LOG_TRACE("Cleaning up GameObject of %s", obj.model == MODEL_NONE ? "no model" : modelFiles[obj.model].objFile);
+
+	// Delete OpenGL buffers and the Vertex Array Object (VAO) now instead of when the object is destroyed
+	obj.vertexBuffer.reset();
+	obj.uvBuffer.reset();
+	obj.normalBuffer.reset();
+	obj.vertexArray.reset();
+
+	// Textures belong to the OBJ cache, only the list is released
+	std::vector<GLuint>().swap(obj.textureIDs);
+	obj.vertexCount = 0;
+}
 
-	// Delete OpenGL buffers associated with the object
-	if (obj.vertexBuffer)
-	{
-		glDeleteBuffers(1, &obj.vertexBuffer);
-		obj.vertexBuffer = 0; // Reset the buffer ID
-	}
-	if (obj.uvBuffer)
-	{
-		glDeleteBuffers(1, &obj.uvBuffer);
-		obj.uvBuffer = 0; // Reset the buffer ID
-	}
-	if (obj.normalBuffer)
-	{
-		glDeleteBuffers(1, &obj.normalBuffer);
-		obj.normalBuffer = 0; // Reset the buffer ID
-	}
 
-	// Delete the Vertex Array Object (VAO)
-	if (obj.vertexArrayID)
+//-------------------------------------------------------------------------------------------------
+// Function to load the laser mesh and texture into the laser batch
+bool loadLasers()
+{
+	if (!OBJloadingfunction(MODEL_LASER))
 	{
-		glDeleteVertexArrays(1, &obj.vertexArrayID);
-		obj.vertexArrayID = 0; // Reset the VAO ID
+		LOG_ERROR("Failed to load the laser model: %s", modelFiles[MODEL_LASER].objFile);
+		return false;
 	}
 
-	// Delete textures associated with the object
-	for (GLuint& textureID : obj.textureIDs)
-	{
-		if (textureID)
-		{
-			glDeleteTextures(1, &textureID);
-			textureID = 0; // Reset the texture ID
-		}
-	}
+	// The batch takes the texture and uploads its own copy of the mesh, the lasers keep the bounds for collisions
+	ObjCache& cache = objCache[MODEL_LASER];
+	modelBounds[MODEL_LASER] = cache.bounds;
+	GLTexture texture = cache.textureHandles.empty() ? GLTexture() : std::move(cache.textureHandles[0]);
+	bool loaded = initLaserBatch(cache.vertices, cache.uvs, cache.normals, std::move(texture));
+
+	// Nothing else draws the model, so its cache entry is emptied right away
+	memRemove(MEM_MESH_CPU, cache.meshBytes());
+	cache = ObjCache();
+	return loaded;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// General cleanup function to clear all resources
-void effectclean(std::vector<Explosion> explosions, std::vector<Laser> lasers)
+// Function to start a level of the world and drop what the renderer kept of the previous one
+void loadWorldLevel(World& world, int number)
 {
-	// Start of the cleanup process
-
-
-	// Clean up lasers and clear their vector
-	for (auto& laser : lasers)
-	{
-		cleanupGameObject(laser.obj); // Clean up the laser objects
-	}
-	lasers.clear(); // Clear the laser vector
+	world.unloadLevel();
+	clearExplosions(); // Explosions are only records in the renderer's ring
+	printMemStats("after unloading the level"); // Anything left besides models, text and textures is a leak
 
-	for (auto& explosion : explosions)
-	{
-		cleanupGameObject(explosion.obj); // Clean up the explosion objects
-	}
-	explosions.clear(); // Clear the explosion vector
+	world.startLevel(number);
 
+	char label[64];
+	sprintf(label, "after loading level %d", world.levelNumber);
+	printMemStats(label);
+}
 
 
-	// End of the cleanup process
-	DEBUG_PRINT("Effects cleanup complete!");
+//-------------------------------------------------------------------------------------------------
+// Function to read the player's controls from the keyboard's actions
+PlayerInput readPlayerInput()
+{
+	// A tap shorter than a frame is released again by now, its pressed edge still counts
+	PlayerInput input;
+	input.left = isActionDown(ACTION_MOVE_LEFT) || wasActionPressed(ACTION_MOVE_LEFT);     // 'A' moves left
+	input.right = isActionDown(ACTION_MOVE_RIGHT) || wasActionPressed(ACTION_MOVE_RIGHT);  // 'D' moves right
+	input.fire = isActionDown(ACTION_FIRE) || wasActionPressed(ACTION_FIRE);               // Spacebar fires
+	return input;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to handle player movement based on user input
-void handlePlayerMovement(GameObject& player, float deltaTime)
-{
-	// Move player left when 'A' key is pressed
-	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		player.position.x -= PLAYER_SPEED * deltaTime;
+// Function to handle game states and transitions, each key acts once when it goes down
+void handleGameStates(World& world) {
+	// "P" pauses and unpauses the game
+	if (wasActionPressed(ACTION_PAUSE)) {
+		if (world.state == GAME_PLAYING) {
+			world.state = GAME_PAUSED;  // Pause the game
+		}
+		else if (world.state == GAME_PAUSED) {
+			world.state = GAME_PLAYING; // Unpause the game
+		}
 	}
 
-	// Move player right when 'D' key is pressed
-	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		player.position.x += PLAYER_SPEED * deltaTime;
+	// "Enter" starts the game from the start menu, and the next level after a win
+	if (wasActionPressed(ACTION_CONFIRM)) {
+		if (world.state == GAME_START) {
+			world.state = GAME_PLAYING;  // Start the game
+		}
+		else if (world.state == NEW_LEVEL) {
+			world.state = NEW_LEVEL_START;
+		}
 	}
 
-	// Ensure player stays within the screen boundaries
-	if (player.position.x < LEFTBOUNDARY)
-	{
-		player.position.x = LEFTBOUNDARY; // Prevent movement beyond the left boundary
+	// "R" restarts the game after a game over
+	if (wasActionPressed(ACTION_RESTART) && world.state == GAME_OVER) {
+		world.state = GAME_RESET;
 	}
-	if (player.position.x > RIGHTBOUNDARY)
-	{
-		player.position.x = RIGHTBOUNDARY; // Prevent movement beyond the right boundary
+
+	// "K" wins the current level at once
+	if (wasActionPressed(ACTION_SKIP_LEVEL) && world.state == GAME_PLAYING) {
+		world.state = NEW_LEVEL;
 	}
 
-	// Fire a laser when the Spacebar is pressed and cooldown time has passed
-	if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && (glfwGetTime() - lastShotTime) >= SHOT_COOLDOWN)
-	{
-		Laser newLaser;
-		createLaser(newLaser, player.position, player.position + glm::vec3(0.0f, 2.0f, 0.0f), true); // Fire laser above the player
-		lasers.push_back(newLaser); // Add new laser to the lasers array
-		lastShotTime = glfwGetTime(); // Update last shot time for cooldown management
+	// "F3" toggles the statistics overlay
+	if (wasActionPressed(ACTION_TOGGLE_STATS)) {
+		showStats = !showStats;
 	}
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to update the positions of aliens
-void updateAlienPositions(std::vector<GameObject>& aliens_vector)
+// Function to add a model drawn at a position and scale to this frame's render batch, bounds are the model's at that scale
+void addToRenderBatch(ModelId model, const glm::vec3& position, float scale, const Bounds& bounds)
 {
-	bool hitBoundary = false;
+	// Bounding sphere in world space, stored per component so culling can test several spheres at once
+	glm::vec3 center = position + bounds.center;
+	renderBatch.objects.push_back(&modelObjects[model]);
+	renderBatch.positions.push_back(position);
+	renderBatch.scales.push_back(scale);
+	renderBatch.x.push_back(center.x);
+	renderBatch.y.push_back(center.y);
+	renderBatch.z.push_back(center.z);
+	renderBatch.radius.push_back(bounds.radius);
+}
+
 
-	// Check if any alien has hit the boundary
-	for (auto& alien : aliens_vector)
+//-------------------------------------------------------------------------------------------------
+// Function to render every visible object of the world, culling against the camera frustum first
+void renderScene(const World& world, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID, const glm::mat4& ProjectionMatrix, const glm::mat4& ViewMatrix)
+{
+	const Level& level = *world.level;
+
+	// Gather every object that would be drawn this frame
+	renderBatch.objects.clear();
+	renderBatch.positions.clear();
+	renderBatch.scales.clear();
+	renderBatch.x.clear();
+	renderBatch.y.clear();
+	renderBatch.z.clear();
+	renderBatch.radius.clear();
+
+	if (!world.isBlinking)
 	{
-		// If alien moves beyond the right boundary, mark it to reverse direction
-		if (alienMovingRight && alien.position.x > RIGHTBOUNDARY)
-		{
-			hitBoundary = true;
-		}
-		// If alien moves beyond the left boundary, mark it to reverse direction
-		if (!alienMovingRight && alien.position.x < LEFTBOUNDARY)
-		{
-			hitBoundary = true;
-		}
+		addToRenderBatch(level.playerShip.model, level.playerShip.position, level.playerShip.scale, level.playerShip.bounds); // Player ship is hidden while blinking
 	}
-
-	// Reverse direction and move down if a boundary is hit
-	if (hitBoundary)
+	if (world.mothershipAlive)
 	{
-		alienMovingRight = !alienMovingRight; // Reverse the alien movement direction
-		for (auto& alien : aliens_vector)
-		{
-			alien.position.y -= alienDropDistance; // Drop aliens down after reversing direction
-		}
+		addToRenderBatch(level.motherShip.model, level.motherShip.position, level.motherShip.scale, level.motherShip.bounds);
+	}
+	for (size_t i = 0; i < level.aliens.size(); i++)
+	{
+		ModelId model = alienModels[level.aliens.model[i]];
+		addToRenderBatch(model, level.aliens.position(i), 1.0f, modelBounds[model]);
+	}
+	for (const Shield& shield : level.shields)
+	{
+		addToRenderBatch(shield.obj.model, shield.obj.position, shield.obj.scale, shield.obj.bounds);
 	}
 
-	// Update positions of aliens based on the current movement direction
-	float direction = alienMovingRight ? 1.0f : -1.0f; // Set direction for movement (right or left)
-	for (auto& alien : aliens_vector)
+	// Lasers are not culled, they are deactivated as soon as they leave the playfield
+	laserInstances.clear();
+	for (const Laser& laser : world.lasers)
 	{
-		alien.position.x += alienSpeed * direction; // Move aliens horizontally
+		if (laser.active)
+		{
+			laserInstances.push_back({ laser.position, laser.direction });
+		}
 	}
-}
+	// Test all bounding spheres against the view frustum in one batch
+	size_t count = renderBatch.objects.size();
+	renderBatch.visible.resize(count);
+	Frustum frustum = extractFrustum(ProjectionMatrix * ViewMatrix);
+	size_t visibleCount = cullSpheres(frustum, renderBatch.x.data(), renderBatch.y.data(), renderBatch.z.data(), renderBatch.radius.data(), count, renderBatch.visible.data());
 
+	cullStats.drawn = static_cast<int>(visibleCount);
+	cullStats.culled = static_cast<int>(count - visibleCount);
 
-//-------------------------------------------------------------------------------------------------
-// Function to update the mothership's position
-void updateMothershipPosition(GameObject& motherShip)
-{
-	// Reverse direction if mothership hits screen boundaries
-	if (motherShip.position.x < LEFTBOUNDARY || motherShip.position.x > RIGHTBOUNDARY)
+	// Submit only the visible objects
+	beginGpuPass(GPU_PASS_OPAQUE);
+	for (size_t i = 0; i < count; i++)
 	{
-		mothershipMovingRight = !mothershipMovingRight; // Reverse mothership movement direction
+		GameObject& obj = *renderBatch.objects[i];
+		if (renderBatch.visible[i])
+		{
+			obj.modelMatrix = glm::translate(glm::mat4(1.0f), renderBatch.positions[i]); // Move the object to its position
+			obj.modelMatrix = glm::scale(obj.modelMatrix, glm::vec3(renderBatch.scales[i])); // Apply the entity's scale
+			renderObject(obj, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix);
+		}
 	}
 
-	// Move the mothership based on its direction
-	if (mothershipMovingRight)
+	// Every active laser in a single instanced draw call
+	if (drawLaserBatch(laserInstances, ProjectionMatrix, ViewMatrix))
 	{
-		motherShip.position.x += mothershipSpeed; // Move right
+		drawCalls++;
 	}
-	else
+	endGpuPass(GPU_PASS_OPAQUE);
+
+	// Explosions are drawn after everything else, all of them with a single instanced draw call.
+	// They are spawned on the world's clock, so they age with the game.
+	beginGpuPass(GPU_PASS_EXPLOSIONS);
+	if (drawExplosions(ProjectionMatrix, ViewMatrix, world.time))
 	{
-		motherShip.position.x -= mothershipSpeed; // Move left
+		drawCalls++;
 	}
+	endGpuPass(GPU_PASS_EXPLOSIONS);
 }
 
-
 //-------------------------------------------------------------------------------------------------
-// Function to update laser position
-void updateLaser(Laser& laser, float deltaTime)
+// Function to draw the start screen text
+void renderStartScreen()
 {
-	if (!laser.active)
-		return; // Skip if laser is inactive
+	char STARTTEXT[256];
+	sprintf(STARTTEXT, "WELCOME TO SPACE INVADERS");
+	printText2D(STARTTEXT, 20, 500, 30);
 
+	char MOVELEFTTEXT[256];
+	sprintf(MOVELEFTTEXT, "A - Move Left");
+	printText2D(MOVELEFTTEXT, 20, 360, 20);
 
-	// Move the laser in its direction based on speed and delta time
-	laser.obj.position += laser.direction * laser.speed * deltaTime;
+	char MOVERIGHTTEXT[256];
+	sprintf(MOVERIGHTTEXT, "D - Move Right");
+	printText2D(MOVERIGHTTEXT, 400, 360, 20);
 
+	char SHOOTTEXT[256];
+	sprintf(SHOOTTEXT, "Spacebar - Shoot");
+	printText2D(SHOOTTEXT, 210, 280, 20);
 
+	char PAUSETEXT[256];
+	sprintf(PAUSETEXT, "P - Pause Game");
+	printText2D(PAUSETEXT, 20, 200, 20);
 
-	// Deactivate laser if it moves off the screen (y-axis or x-axis exceeds a certain limit)
-	if (laser.obj.position.y > 35.0f || laser.obj.position.y < -35.0f || laser.obj.position.x > 55.0f || laser.obj.position.x < -55.0f)
-	{
-		laser.active = false; // Laser is no longer active
-	}
+	char PLAYERCAMERATEXT[256];
+	sprintf(PLAYERCAMERATEXT, "1 - Player Camera");
+	printText2D(PLAYERCAMERATEXT, 400, 200, 20);
 
-}
+	char BATTLECAMERATEXT[256];
+	sprintf(BATTLECAMERATEXT, "2 - Front Camera");
+	printText2D(BATTLECAMERATEXT, 20, 120, 20);
 
+	char FREECAMERATEXT[256];
+	sprintf(FREECAMERATEXT, "3 - Free Camera");
+	printText2D(FREECAMERATEXT, 400, 120, 20);
 
-//-------------------------------------------------------------------------------------------------
-// Function to render a laser if it is active
-void renderLaser(Laser& laser, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID, const glm::mat4& ProjectionMatrix, const glm::mat4& ViewMatrix)
-{
-	// Only render laser if it's active
-	if (laser.active)
-	{
-		// Update the model matrix to translate the laser to its current position
-		laser.obj.modelMatrix = glm::translate(glm::mat4(1.0f), laser.obj.position);
-		renderObject(laser.obj, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix); // Call to render the laser object
-	}
+	char INSTRUCTIONSTEXT[256];
+	sprintf(INSTRUCTIONSTEXT, "Press ENTER to Start");
+	printText2D(INSTRUCTIONSTEXT, 20, 20, 35);
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to check if a laser collides with an alien
-bool checkLaserAlienCollision(const Laser& laser, GameObject& alien)
+// Function to draw the lives, points and statistics overlay while playing
+void renderHUD(const World& world)
 {
+	beginGpuPass(GPU_PASS_TEXT);
+
+	char life_text[256];
+	sprintf(life_text, "LIFES %d", world.level->playerHealth);
+	printText2D(life_text, 20, 20, 25);
 
-	if (laser.player_friendly == false)
+	char points_text[256];
+	sprintf(points_text, "POINTS %d", world.playerPoints);
+	printText2D(points_text, 450, 20, 25);
+
+	if (showStats)
 	{
-		return false; // Skip if laser is friendly to object
-	}
+		char cull_text[256];
+		sprintf(cull_text, "DRAWN %d CULLED %d", cullStats.drawn, cullStats.culled);
+		printText2D(cull_text, 20, 570, 15);
 
+		char gpu_text[256];
+		sprintf(gpu_text, "GPU MS OPAQUE %.2f EXPL %.2f TEXT %.2f", getGpuPassTime(GPU_PASS_OPAQUE), getGpuPassTime(GPU_PASS_EXPLOSIONS), getGpuPassTime(GPU_PASS_TEXT));
+		printText2D(gpu_text, 20, 550, 15);
 
-	// Calculate the distance between the laser and the alien
-	float distance = glm::length(laser.obj.position - alien.position);
+		char mem_text[256];
+		sprintf(mem_text, "MEM KB MESH %zu GPU %zu TEX %zu", memCurrent(MEM_MESH_CPU) / 1024, memCurrent(MEM_MESH_GPU) / 1024, memCurrent(MEM_TEXTURES) / 1024);
+		printText2D(mem_text, 20, 530, 15);
 
-	// Assume a collision threshold distance for laser and alien
-	float threshold = 2.0f;
+		char mem2_text[256];
+		sprintf(mem2_text, "MEM KB TEXT %zu ENT %zu TOTAL %zu", memCurrent(MEM_TEXT_BUFFERS) / 1024, memCurrent(MEM_ENTITIES) / 1024, memTotal() / 1024);
+		printText2D(mem2_text, 20, 510, 15);
 
-	// Return true if the laser collides with the alien based on the distance
-	return distance < threshold;
+		char latency_text[256];
+		sprintf(latency_text, "INPUT MS LAST %.1f MEAN %.1f", getLastInputLatency(), getMeanInputLatency());
+		printText2D(latency_text, 20, 490, 15);
+	}
+
+	endGpuPass(GPU_PASS_TEXT);
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to handle collisions between lasers and aliens
-void handleLaserAlienCollisions(std::vector<GameObject>& aliens, std::vector<Explosion>& explosions)
+// Function to render the golden scenes and compare them against (or record) reference images
+int runGoldenFrames(World& world, const char* directory, bool update, GLuint programID, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID)
 {
-	// Iterate over all lasers and check for collisions
-	for (auto laserIt = lasers.begin(); laserIt != lasers.end();)
+	const char* sceneNames[GOLDEN_SCENE_COUNT] = { "start_menu", "alien_grid", "mid_battle" };
+	int failures = 0;
+
+	// Every scene is seen from the fixed front camera
+	cameraMode = 2;
+
+	for (int scene = 0; scene < GOLDEN_SCENE_COUNT; scene++)
 	{
-		if (!laserIt->active)
-		{
-			// Remove inactive lasers from the array
-			laserIt = lasers.erase(laserIt);
-		}
-		else
+		// Start every scene from a fresh first level
+		loadWorldLevel(world, 1);
+		world.playerPoints = 0;
+		Level& level = *world.level;
+
+		if (scene == GOLDEN_MID_BATTLE)
 		{
-			// Check if laser collides with any alien
-			for (auto it = aliens.begin(); it != aliens.end();)
+			// Destroy every other alien of the front row, leaving an explosion where each one was
+			int removed = 0;
+			size_t frontRowStart = level.aliens.size() - level.definition.colAliens;
+			for (size_t i = level.aliens.size(); i-- > frontRowStart; )
 			{
-				if (checkLaserAlienCollision(*laserIt, *it))
-				{
-					// Create an explosion at the alien's position
-					Explosion explosion;
-					createExplosion(explosion, it->position);
-					explosions.push_back(explosion);
-
-					playerPoints += 5; // Add 50 points for each alien destroyed
-
-					it = aliens.erase(it);   // Remove alien from the array on collision
-					laserIt->active = false; // Deactivate the laser after collision
-					break;                   // Stop checking once the laser hits an alien
-				}
-				else
+				if (i % 2 == 0)
 				{
-					++it; // Continue checking for other aliens
+					spawnExplosion(level.aliens.position(i), world.time);
+					level.aliens.kill(i);
+					removed++;
 				}
 			}
+			world.playerPoints = removed * 5;
+			removeDeadEntities(world);
 
-			++laserIt; // Move to the next laser
-		}
-	}
-}
-
-
-//-------------------------------------------------------------------------------------------------
-// Function to check if a laser collides with the mothership
-bool checkLaserMothershipCollision(const Laser& laser, GameObject& motherShip)
-{
-
-	if (laser.player_friendly == false)
-	{
-		return false; // Skip if laser is friendly to object
-	}
-
-	if (!mothershipAlive)
-	{
-		return false; // Skip if mothership is not alive
-	}
-	// Calculate the distance between the laser and the mothership
-	float distance = glm::length(laser.obj.position - motherShip.position);
-
-	// Define a threshold for collision detection (can adjust as necessary)
-	float threshold = 2.0f;
+			// Lasers in flight from both sides
+			for (int i = 0; i < 3; i++)
+			{
+				Laser playerLaser;
+				createLaser(world, playerLaser, level.playerShip.position, glm::vec3(-20.0f + i * 20.0f, -10.0f, 0.0f), true);
+				world.lasers.push_back(playerLaser);
 
-	// Return true if laser collides with the mothership
-	return distance < threshold;
-}
+				Laser alienLaser;
+				createLaser(world, alienLaser, level.playerShip.position, glm::vec3(-10.0f + i * 15.0f, 5.0f, 0.0f), false);
+				world.lasers.push_back(alienLaser);
+			}
+		}
 
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glUseProgram(programID);
 
-//-------------------------------------------------------------------------------------------------
-// Function to handle laser collisions with the mothership
-void handleLaserMothershipCollision(GameObject& mothership, std::vector<Explosion>& explosions)
-{
-	// Iterate over all lasers and check for collision with the mothership
-	for (auto laserIt = lasers.begin(); laserIt != lasers.end();)
-	{
-		if (!laserIt->active)
+		if (scene == GOLDEN_START_MENU)
 		{
-			// Remove inactive lasers
-			laserIt = lasers.erase(laserIt);
+			renderStartScreen();
 		}
 		else
 		{
-			// Check for collision with the mothership
-			if (checkLaserMothershipCollision(*laserIt, mothership))
-			{
-				mothershipHealth -= 1;   // Decrease mothership health on hit
-				laserIt->active = false; // Deactivate the laser after collision
+			computeMatricesFromInput(level.playerShip.position);
+			renderScene(world, MatrixID, ModelMatrixID, ViewMatrixID, textureID, getProjectionMatrix(), getViewMatrix());
+			renderHUD(world);
+		}
 
-				// Check if mothership is destroyed
-				if (mothershipHealth <= 0)
-				{
-					mothershipAlive = false; // Set mothership as destroyed
-					DEBUG_PRINT("Mothership Destroyed!");
+		glUseProgram(0);
 
-					playerPoints += 50; // Add 500 points for each mothership destroyed
+		// Read the frame back and compare it with the stored reference
+		std::vector<unsigned char> pixels;
+		readFrame(pixels);
 
-					// Create an explosion at the mothership's position
-					Explosion explosion;
-					createExplosion(explosion, mothership.position);
-					explosions.push_back(explosion);
-
-					cleanupGameObject(mothership); // Clean up mothership resources
-				}
+		std::string referencePath = std::string(directory) + "/" + sceneNames[scene] + ".png";
+		if (update)
+		{
+			bool written = writePNG(referencePath.c_str(), frameWidth, frameHeight, 3, &pixels[0], false);
+			printf("%-12s %s\n", sceneNames[scene], written ? "RECORDED" : "WRITE FAILED");
+			failures += written ? 0 : 1;
+			continue;
+		}
 
-				break; // Stop checking once a laser hits the mothership
-			}
-			else
+		int width, height, channels;
+		unsigned char* reference = stbi_load(referencePath.c_str(), &width, &height, &channels, 3);
+		if (!reference || width != frameWidth || height != frameHeight)
+		{
+			printf("%-12s FAIL missing or mismatched reference %s\n", sceneNames[scene], referencePath.c_str());
+			if (reference)
 			{
-				++laserIt; // Move to the next laser
+				stbi_image_free(reference);
 			}
+			failures++;
+			continue;
 		}
-	}
-}
 
+		ImageDifference difference = compareImages(&pixels[0], reference, frameWidth, frameHeight, 3, GOLDEN_PIXEL_TOLERANCE);
+		stbi_image_free(reference);
 
-//-------------------------------------------------------------------------------------------------
-// Function to handle alien laser firing
-void handleAlienLaserFiring(std::vector<GameObject>& aliens_vector, const glm::vec3& playerPosition, int value, GameObject& player)
-{
-	for (auto& alien : aliens_vector)
-	{
-		// Random chance for each alien to fire
-		if (rand() % 150000 < value) //  chance for each alien to fire 
-		{
-			Laser newLaser;
-			createLaser(newLaser, player.position, alien.position + glm::vec3(0.0f, -2.0f, 0.0f), false, alien.position);
-			lasers.push_back(newLaser); // Add new laser to the lasers array
+		bool passed = difference.differingFraction <= GOLDEN_MAX_DIFFERING_FRACTION;
+		printf("%-12s %s rmse %.3f max %d differing %.4f%%\n", sceneNames[scene], passed ? "PASS" : "FAIL",
+			difference.rmse, difference.maxDifference, difference.differingFraction * 100.0);
 
+		if (!passed)
+		{
+			// Keep the failing frame next to the reference for inspection
+			std::string actualPath = std::string(directory) + "/" + sceneNames[scene] + "_actual.png";
+			writePNG(actualPath.c_str(), frameWidth, frameHeight, 3, &pixels[0], false);
+			failures++;
 		}
 	}
+
+	return failures == 0 ? 0 : 1;
 }
 
 
-//-------------------------------------------------------------------------------------------------
-// Function to handle mothership laser firing
-void handleMothershipLaserFiring(GameObject& motherShip, int value, GameObject& player)
-{
-	// Random chance for mothership to fire
-	if (rand() % 300 < value) //  chance for mothership to fire 
-	{
-		Laser newLaser;
-		createLaser(newLaser, player.position, motherShip.position + glm::vec3(0.0f, -2.0f, 0.0f), false);
-		lasers.push_back(newLaser); // Add laser to the list of lasers
+void checkOpenGLError(const std::string& location) {
+	GLenum err;
+	while ((err = glGetError()) != GL_NO_ERROR) {
+		LOG_ERROR("OpenGL error at %s: 0x%x", location.c_str(), err);
 	}
 }
 
 
-//-------------------------------------------------------------------------------------------------
-// Function to check if a laser collides with a shield
-bool checkLaserShieldCollision(const Laser& laser, Shield& shield)
-{
-	if (!laser.active)
-		return false; // Skip if laser is inactive
-
-	// Calculate the distance between the laser and the shield
-	float distance = glm::length(laser.obj.position - shield.obj.position);
-
-	// Define a threshold for collision detection (can adjust as necessary)
-	float threshold = 6.5f;
-
-	// Return true if laser collides with the shield
-	return distance < threshold;
-}
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to handle collisions between lasers and shields
-void handleLaserShieldCollisions(std::vector<Shield>& shields)
+// Function to time the formation update of alienCount aliens: per object, bulk kernels and formation origin
+void runFormationBenchmark(int alienCount)
 {
-	for (auto laserIt = lasers.begin(); laserIt != lasers.end();)
+	const int ticks = 2000;
+	const int columns = 100;
+	const int rows = (alienCount + columns - 1) / columns;
+
+	// A wide grid that reaches a boundary every few hundred ticks, so drops are part of the measurement
+	std::vector<Entity> objects;
+	objects.reserve(alienCount);
+	std::vector<float> scalarX, scalarY, simdX, simdY;
+	AlienFormation formation(std::pmr::new_delete_resource());
+	formation.reserve(rows, columns);
+	for (int i = 0; i < alienCount; i++)
+	{
+		glm::vec3 position(-45.0f + (i % columns) * 0.9f, 25.0f - (i / columns) * 0.5f, 0.0f);
+		Entity alien;
+		alien.position = position;
+		objects.push_back(alien);
+		scalarX.push_back(position.x);
+		scalarY.push_back(position.y);
+		formation.add(position, i / columns, i % columns, 0, i);
+	}
+	simdX = scalarX;
+	simdY = scalarY;
+
+	// The update as it was done per alien object: scan every alien for the boundary, then move each one
+	bool movingRight = true;
+	auto start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < ticks; tick++)
 	{
-		if (!laserIt->active)
+		bool hitBoundary = false;
+		for (const Entity& alien : objects)
 		{
-			laserIt = lasers.erase(laserIt); // Remove inactive lasers
+			if ((movingRight && alien.position.x > RIGHTBOUNDARY) || (!movingRight && alien.position.x < LEFTBOUNDARY))
+			{
+				hitBoundary = true;
+			}
 		}
-		else
+		if (hitBoundary)
 		{
-			for (auto shieldIt = shields.begin(); shieldIt != shields.end();)
+			movingRight = !movingRight;
+			for (Entity& alien : objects)
 			{
-				if (checkLaserShieldCollision(*laserIt, *shieldIt))
-				{
-					if (laserIt->player_friendly == true)
-					{
-						// If the laser is friendly, deactivate the laser without affecting shield health
-						laserIt->active = false;
-					}
-					else
-					{
-
-						shieldIt->health -= 1; // Decrease shield health on hit
-						laserIt->active = false; // Deactivate the laser after collision
-
-						if (shieldIt->health <= 0)
-						{
-							cleanupGameObject(shieldIt->obj); // Clean up shield resources
-							shieldIt = shields.erase(shieldIt); // Remove shield if health is depleted
-						}
-						else
-						{
-							++shieldIt; // Move to the next shield
-						}
-					}
-					break; // Stop checking once a laser hits a shield
-				}
-				else
-				{
-					++shieldIt; // Move to the next shield
-				}
+				alien.position.y -= alienDropDistance;
 			}
-
-			++laserIt; // Move to the next laser
+		}
+		for (Entity& alien : objects)
+		{
+			alien.position.x += movingRight ? 0.05f : -0.05f;
 		}
 	}
-}
+	double perObjectUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ticks;
 
-
-//-------------------------------------------------------------------------------------------------
-// Function to check if a laser collides with the player
-bool checkLaserPlayerCollision(const Laser& laser, GameObject& player)
-{
-	if (laser.player_friendly)
+	// Every position moved in bulk over plain arrays
+	movingRight = true;
+	start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < ticks; tick++)
 	{
-		return false; // Skip if laser is friendly to player
+		movingRight = stepPositions(scalarX.data(), scalarY.data(), scalarX.size(), movingRight, 0.05f, alienDropDistance, LEFTBOUNDARY, RIGHTBOUNDARY, false);
 	}
+	double scalarUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ticks;
 
-	// Calculate the distance between the laser and the player
-	float distance = glm::length(laser.obj.position - player.position);
+	movingRight = true;
+	start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < ticks; tick++)
+	{
+		movingRight = stepPositions(simdX.data(), simdY.data(), simdX.size(), movingRight, 0.05f, alienDropDistance, LEFTBOUNDARY, RIGHTBOUNDARY, true);
+	}
+	double simdUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ticks;
 
-	// Define a threshold for collision detection (can adjust as necessary)
-	float threshold = 2.0f;
+	// Only the formation's origin moves
+	movingRight = true;
+	start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < ticks; tick++)
+	{
+		movingRight = stepFormation(formation, movingRight, 0.05f, alienDropDistance, LEFTBOUNDARY, RIGHTBOUNDARY);
+	}
+	double originUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ticks;
 
-	// Return true if laser collides with the player
-	return distance < threshold;
+	// All of them must end in the same place, otherwise the timings compare different work.
+	// The origin sums the steps once instead of per alien, so its rounding differs slightly.
+	bool same = true;
+	for (int i = 0; i < alienCount; i++)
+	{
+		glm::vec3 slotted = formation.position(i);
+		same = same && objects[i].position.x == simdX[i] && objects[i].position.y == simdY[i] &&
+			scalarX[i] == simdX[i] && scalarY[i] == simdY[i] &&
+			fabs(slotted.x - simdX[i]) < 0.01f && fabs(slotted.y - simdY[i]) < 0.01f;
+	}
+
+	printf("Formation update of %d aliens, %d ticks\n", alienCount, ticks);
+	printf("  per object        %9.3f us/tick\n", perObjectUs);
+	printf("  scalar kernels    %9.3f us/tick  %7.1fx\n", scalarUs, perObjectUs / scalarUs);
+	printf("  %-6s kernels    %9.3f us/tick  %7.1fx\n", formationKernelName(), simdUs, perObjectUs / simdUs);
+	printf("  formation origin  %9.3f us/tick  %7.1fx\n", originUs, perObjectUs / originUs);
+	printf("  results %s\n", same ? "match" : "DIFFER");
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Function to handle collisions between lasers and the player
-int handleLaserPlayerCollisions(GameObject& player, int playerHealth)
+// Main function that runs the program
+int main(int argc, char* argv[])
 {
-	double currentTime = glfwGetTime(); // Get the current time
-
-	// Check if the player is invincible and if the invincibility period has expired
-	if (isInvincible && (currentTime - lastHitTime) >= INVINCIBILITY_DURATION)
+	// Start writing log messages from the background thread
+	startLog();
+
+	// Parse the command line
+	RenderBackend backend = BACKEND_WINDOW;  // Render to a window unless --offscreen is given
+	const char* dumpDirectory = NULL;        // Folder to write every frame to as PNG (--dump-frames)
+	int maxFrames = 0;                       // Number of frames to render before exiting, 0 = until closed (--frames)
+	const char* goldenDirectory = NULL;      // Folder of the golden reference images (--golden / --golden-update)
+	bool goldenUpdate = false;               // Record new reference images instead of comparing
+	bool benchmark = false;                  // Play a scripted session and write a report (--benchmark)
+	const char* reportPath = "benchmark.json"; // Where the benchmark report is written (--report)
+	BenchmarkConfig config;                  // Level, duration, seed, camera and resolution, also used outside benchmarks
+	int formationBenchmark = 0;              // Time the formation update of this many aliens and exit (--formation-benchmark)
+	GameState initialState = GAME_START;     // State the game starts in, --play skips the start menu
+	const char* snapshotPath = NULL;         // World state to start from instead of a new level (--snapshot)
+	const char* recordInputPath = NULL;      // Where the keyboard's events are recorded (--record-input)
+	const char* replayInputPath = NULL;      // Recording played back instead of the keyboard (--replay-input)
+	FramePacing pacing;                      // Input sampling, swap interval and frame cap (--low-latency, --swap-interval, --fps-cap)
+	config.camera = cameraMode;
+	for (int i = 1; i < argc; i++)
 	{
-		isInvincible = false; // Reset invincibility flag
-	}
-
-	for (auto laserIt = lasers.begin(); laserIt != lasers.end();)
-	{
-		if (!laserIt->active)
+		std::string arg = argv[i];
+		if (arg == "--offscreen" || arg == "--headless")
 		{
-			laserIt = lasers.erase(laserIt); // Remove inactive lasers
+			backend = BACKEND_OFFSCREEN;
 		}
-		else
+		else if (arg == "--dump-frames" && i + 1 < argc)
 		{
-			if (!isInvincible && checkLaserPlayerCollision(*laserIt, player))
-			{
-				playerHealth -= 1; // Decrease player health on hit
-				laserIt->active = false; // Deactivate the laser after collision
-
-				if (playerHealth <= 0)
-				{
-					currentState = GAME_OVER; // Transition to game over state
-					DEBUG_PRINT("Player Killed!");
-				}
-				else
-				{
-					isInvincible = true; // Set invincibility flag
-					lastHitTime = currentTime; // Update last hit time
-					nextBlinkTime = currentTime; // Initialize next blink time
-					DEBUG_PRINT("Player Hit! Invincibility activated.");
-				}
-
-				break; // Stop checking once a laser hits the player
-			}
-			else
-			{
-				++laserIt; // Move to the next laser
-			}
+			dumpDirectory = argv[++i];
 		}
-	}
-
-	return playerHealth;
-}
-
-
-//-------------------------------------------------------------------------------------------------
-// Function to handle game states and transitions
-void handleGameStates() {
-	// Detect "P" key press and release for pausing/unpausing
-	static bool pKeyPressed = false;
-	if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
-		if (!pKeyPressed) {
-			if (currentState == GAME_PLAYING) {
-				currentState = GAME_PAUSED;  // Pause the game
-			}
-			else if (currentState == GAME_PAUSED) {
-				currentState = GAME_PLAYING; // Unpause the game
-			}
-			pKeyPressed = true; // Flag that the key is pressed
+		else if (arg == "--frames" && i + 1 < argc)
+		{
+			maxFrames = atoi(argv[++i]);
 		}
-	}
-	else if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE) {
-		pKeyPressed = false; // Reset the flag when the key is released
-	}
-
-	// Detect "Enter" key press to start the game
-	static bool enterKeyPressed = false;
-	if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS) {
-		if (!enterKeyPressed) {
-			if (currentState == GAME_START) {
-				currentState = GAME_PLAYING;  // Start the game
-			}
-			enterKeyPressed = true; // Flag that the key is pressed
+		else if (arg == "--play")
+		{
+			initialState = GAME_PLAYING; // Skip the start menu
 		}
-	}
-	else if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_RELEASE) {
-		enterKeyPressed = false; // Reset the flag when the key is released
-	}
-
-	// Detect "R" key press for restarting the game
-	static bool rKeyPressed = false;
-	if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
-		if (!rKeyPressed) {
-			if (currentState == GAME_OVER) {
-
-				currentState = GAME_RESET; // Restart the game
-				rKeyPressed = true; // Flag that the key is pressed
-			}
+		else if ((arg == "--golden" || arg == "--golden-update") && i + 1 < argc)
+		{
+			goldenUpdate = (arg == "--golden-update");
+			goldenDirectory = argv[++i];
+			backend = BACKEND_OFFSCREEN; // Reference images are rendered on the software context
 		}
-	}
-	else if (glfwGetKey(window, GLFW_KEY_R) == GLFW_RELEASE) {
-		rKeyPressed = false; // Reset the flag when the key is released
-	}
-
-
-	if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS) {
-		if (!pKeyPressed) {
-			if (currentState == NEW_LEVEL) {
-				currentState = NEW_LEVEL_START;
-			}
-
-			pKeyPressed = true; // Flag that the key is pressed
+		else if (arg == "--benchmark")
+		{
+			benchmark = true;
 		}
-	}
-	else if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_RELEASE) {
-		pKeyPressed = false; // Reset the flag when the key is released
-	}
-
-
-	if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS) {
-		if (!pKeyPressed) {
-			if (currentState == GAME_PLAYING) {
-				currentState = NEW_LEVEL;  // Pause the game
-			}
-			pKeyPressed = true; // Flag that the key is pressed
+		else if (arg == "--report" && i + 1 < argc)
+		{
+			reportPath = argv[++i];
 		}
-	}
-	else if (glfwGetKey(window, GLFW_KEY_K) == GLFW_RELEASE) {
-		pKeyPressed = false; // Reset the flag when the key is released
-	}
-
-
-}
-
-
-//-------------------------------------------------------------------------------------------------
-// Function to update explosions
-void updateExplosions(std::vector<Explosion>& explosions)
-{
-	double currentTime = glfwGetTime();
-	for (auto it = explosions.begin(); it != explosions.end();)
-	{
-		if (currentTime - it->spawnTime >= 0.5)
+		else if (arg == "--level" && i + 1 < argc)
+		{
+			config.level = atoi(argv[++i]);
+		}
+		else if (arg == "--duration" && i + 1 < argc)
+		{
+			config.duration = atof(argv[++i]);
+		}
+		else if (arg == "--seed" && i + 1 < argc)
+		{
+			config.seed = static_cast<unsigned int>(strtoul(argv[++i], NULL, 10));
+		}
+		else if (arg == "--camera" && i + 1 < argc)
+		{
+			config.camera = atoi(argv[++i]);
+		}
+		else if (arg == "--resolution" && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &config.width, &config.height) == 2)
+		{
+			i++;
+		}
+		else if (arg == "--record-input" && i + 1 < argc)
+		{
+			recordInputPath = argv[++i];
+		}
+		else if (arg == "--replay-input" && i + 1 < argc)
+		{
+			replayInputPath = argv[++i];
+		}
+		else if (arg == "--low-latency")
+		{
+			pacing.lowLatency = true;
+		}
+		else if (arg == "--swap-interval" && i + 1 < argc)
+		{
+			pacing.swapInterval = atoi(argv[++i]);
+		}
+		else if (arg == "--fps-cap" && i + 1 < argc)
+		{
+			pacing.frameCap = atof(argv[++i]);
+		}
+		else if (arg == "--snapshot" && i + 1 < argc)
+		{
+			snapshotPath = argv[++i];
+		}
+		else if (arg == "--formation-benchmark" && i + 1 < argc && atoi(argv[i + 1]) > 0)
 		{
-			cleanupGameObject(it->obj); // Clean up explosion resources
-			it = explosions.erase(it);  // Remove explosion after half second
+			formationBenchmark = atoi(argv[++i]);
 		}
 		else
 		{
-			++it; // Move to the next explosion
+			printf("Usage: %s [--offscreen | --headless] [--frames N] [--dump-frames DIR] [--play] [--golden DIR | --golden-update DIR]\n"
+				"          [--benchmark] [--report FILE] [--level N] [--duration SECONDS] [--seed N] [--camera 1|2|3] [--resolution WxH]\n"
+				"          [--snapshot FILE] [--record-input FILE] [--replay-input FILE] [--formation-benchmark ALIENS]\n"
+				"          [--low-latency] [--swap-interval N] [--fps-cap FPS]\n", argv[0]);
+			return -1;
 		}
 	}
-}
 
-
-//-------------------------------------------------------------------------------------------------
-// Function to render explosions
-void renderExplosions(Explosion& explosion, GLuint MatrixID, GLuint ModelMatrixID, GLuint ViewMatrixID, GLuint textureID, const glm::mat4& ProjectionMatrix, const glm::mat4& ViewMatrix)
-{
-	if (explosion.active)
+	if (config.level < 1 || config.duration <= 0.0 || config.camera < 1 || config.camera > 3 || config.width <= 0 || config.height <= 0 ||
+		pacing.swapInterval < -1 || pacing.frameCap < 0.0)
 	{
-		explosion.obj.modelMatrix = glm::translate(glm::mat4(1.0f), explosion.obj.position); // Update model matrix
-		renderObject(explosion.obj, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix); // Render explosion
+		printf("Invalid --level, --duration, --camera, --resolution, --swap-interval or --fps-cap value\n");
+		return -1;
 	}
-}
+	config.headless = (backend == BACKEND_OFFSCREEN);
 
-void checkOpenGLError(const std::string& location) {
-	GLenum err;
-	while ((err = glGetError()) != GL_NO_ERROR) {
-		std::cerr << "OpenGL error at " << location << ": " << err << std::endl;
+	// The formation benchmark only exercises the simulation, it needs no OpenGL context
+	if (formationBenchmark > 0)
+	{
+		runFormationBenchmark(formationBenchmark);
+		return 0;
 	}
-}
-
 
-
-
-//-------------------------------------------------------------------------------------------------
-// Main function that runs the program
-int main(void)
-{
-	// Initialize GLFW
-	if (!glfwInit())
+	// Benchmarks play from the first frame and run for their duration instead of a frame count
+	if (benchmark)
 	{
-		DEBUG_PRINT("Failed to initialize GLFW!"); // Error message if GLFW initialization fails
-		return -1;
+		initialState = GAME_PLAYING;
 	}
+	cameraMode = config.camera;
 
-	// Set OpenGL context settings (version and profile)
-	glfwWindowHint(GLFW_SAMPLES, 4); // Anti-aliasing
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3); // Set OpenGL version (major)
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3); // Set OpenGL version (minor)
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // Make OpenGL forward-compatible
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); // Use core OpenGL profile
+	// Nobody can close an offscreen run, so it always stops after a fixed number of frames
+	if (backend == BACKEND_OFFSCREEN && maxFrames <= 0 && !benchmark)
+	{
+		maxFrames = 300;
+	}
 
-	// Create a GLFW window
-	window = glfwCreateWindow(1920, 1080, "Space Invaders 3D | Projeto Final", NULL, NULL);
-	if (window == NULL)
+	// Create the OpenGL context (window or offscreen framebuffer) and initialize GLEW
+	if (!initBackend(backend, config.width, config.height, "Space Invaders 3D | Projeto Final"))
 	{
-		DEBUG_PRINT("Failed to open GLFW window!"); // Error message if window creation fails
-		glfwTerminate();
+		LOG_ERROR("Failed to initialize the rendering backend!"); // Error message if context creation fails
 		return -1;
 	}
 
-	glfwMakeContextCurrent(window); // Make the context of the window current
-
-	glewExperimental = true;
-
-	if (glewInit() != GLEW_OK)
+	// Keys reach the game as queued events mapped to actions (see common/input), nothing polls the keyboard
+	initInput(window);
+	if ((recordInputPath && !startInputRecording(recordInputPath)) || (replayInputPath && !startInputReplay(replayInputPath)))
 	{
-		DEBUG_PRINT("Failed to initialize GLEW!"); // Error message if GLEW initialization fails
-		glfwTerminate();
+		cleanupInput();
+		cleanupBackend();
 		return -1;
 	}
-
-	// Set input modes for GLFW (sticky keys and disable cursor)
-	glfwSetInputMode(window, GLFW_STICKY_KEYS, GL_TRUE); // Ensures keys remain pressed after being detected
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED); // Hides the cursor
+
+	// Vsync as requested, the frame cap and latency measurement start with the main loop
+	initFramePacing(pacing, backend == BACKEND_WINDOW);
 	glfwPollEvents();
-	glfwSetCursorPos(window, static_cast<double>(1920) / 2, static_cast<double>(1080) / 2); // Position the cursor at the center of the window
+	glfwSetCursorPos(window, static_cast<double>(frameWidth) / 2, static_cast<double>(frameHeight) / 2); // Position the cursor at the center of the window
 
 	// OpenGL settings
 	glClearColor(0.25f, 0.25f, 0.25f, 0.0f); // Set background color
@@ -1593,7 +1260,7 @@ int main(void)
 
 	// Load shaders (vertex and fragment shaders)
 	GLuint programID = LoadShaders("shaders/main.vertexshader", "shaders/main.fragmentshader");
-	DEBUG_PRINT("Shaders loaded successfully!");
+	LOG_DEBUG("Shaders loaded successfully!");
 
 	// Get uniform locations for transformation matrices and texture
 	GLuint MatrixID = glGetUniformLocation(programID, "MVP");
@@ -1601,70 +1268,120 @@ int main(void)
 	GLuint ModelMatrixID = glGetUniformLocation(programID, "M");
 	GLuint textureID = glGetUniformLocation(programID, "textureSampler");
 
-	// Create the LevelManager
-	LevelManager LEVELMANAGER;
+	// Create the GPU timer queries for the render passes
+	initGpuTimers();
 
-	// Start the first level
-	LEVELMANAGER.startNextLevel();
-
-	double lastTime = glfwGetTime(); // Store the initial time for deltaTime calculations
+	// Load the level descriptions once, falling back to the built-in progression if the file is unusable
+	std::vector<LevelDefinition> definitions;
+	if (!loadLevelFile("levels/levels.txt", definitions))
+	{
+		LOG_WARN("Using built-in levels");
+		makeDefaultLevels(definitions, 10);
+	}
+	LOG_INFO("Loaded %d levels", static_cast<int>(definitions.size()));
 
 	// Load the font texture for text rendering
 	initText2D("fonts/Holstein.DDS");
 
+	// Upload every model once, this also records the bounds the simulation collides with
+	loadModels();
+	loadExplosions();
+	loadLasers();
 
-	// Main game loop
-	do
-	{
-
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear the screen
+	// The game itself, its random sequence starts from the seed so --seed replays the same alien and mothership fire
+	World world(definitions, modelBounds, config.seed, &entityMemory);
+	world.state = initialState;
 
-		glUseProgram(programID); // Use the shader program
+	// Start the first level (or the one given with --level)
+	loadWorldLevel(world, config.level);
 
-		handleGameStates();
+	// Or fast-forward to a saved battle (see the runner's --save-snapshot), benchmarks also go back to it after a loss
+	std::vector<unsigned char> startSnapshot;
+	if (snapshotPath)
+	{
+		if (readSnapshotFile(snapshotPath, startSnapshot) && restoreSnapshot(world, startSnapshot.data(), startSnapshot.size()))
+		{
+			LOG_INFO("Restored level %d at %.1f s from %s", world.levelNumber, world.time, snapshotPath);
+		}
+		else
+		{
+			LOG_WARN("Invalid snapshot %s, starting level %d instead", snapshotPath, config.level);
+			startSnapshot.clear();
+		}
+	}
 
+	double lastTime = glfwGetTime(); // Store the initial time for deltaTime calculations
 
-		switch (currentState) {
+	// Golden-frame runs render their scenes once and exit with the comparison result
+	if (goldenDirectory)
+	{
+		int result = runGoldenFrames(world, goldenDirectory, goldenUpdate, programID, MatrixID, ModelMatrixID, ViewMatrixID, textureID);
+		world.unloadLevel();
+		cleanupExplosions();
+		cleanupLaserBatch();
+		for (GameObject& obj : modelObjects)
+		{
+			cleanupGameObject(obj);
+		}
+		clearObjCache();
+		cleanupGpuTimers();
+		cleanupText2D();
+		glDeleteProgram(programID);
+		cleanupInput();
+		cleanupBackend();
+		return result;
+	}
 
 
-		case GAME_START:
-			char STARTTEXT[256];
-			sprintf(STARTTEXT, "WELCOME TO SPACE INVADERS");
-			printText2D(STARTTEXT, 20, 500, 30);
+	int frameNumber = 0; // Number of frames rendered so far
 
-			char MOVELEFTTEXT[256];
-			sprintf(MOVELEFTTEXT, "A - Move Left");
-			printText2D(MOVELEFTTEXT, 20, 360, 20);
+	// Benchmark measurements, reserved up front so recording never reallocates during the run
+	BenchmarkResults benchmarkResults;
+	bool benchmarkDone = false;
+	if (benchmark)
+	{
+		size_t expectedFrames = static_cast<size_t>(config.duration * 250.0);
+		benchmarkResults.frameMs.reserve(expectedFrames);
+		benchmarkResults.tickMs.reserve(expectedFrames);
+		benchmarkResults.drawCalls.reserve(expectedFrames);
+	}
+	double benchmarkStart = glfwGetTime();
+	std::chrono::steady_clock::time_point lastFrameEnd = std::chrono::steady_clock::now();
 
-			char MOVERIGHTTEXT[256];
-			sprintf(MOVERIGHTTEXT, "D - Move Right");
-			printText2D(MOVERIGHTTEXT, 400, 360, 20);
+	// Main game loop
+	do
+	{
+		// Hold the loop to the frame cap, then in low-latency mode read the input as late as possible:
+		// right before the state handling and simulation that use it, instead of after the previous frame was presented
+		waitForFrameStart();
+		if (pacing.lowLatency)
+		{
+			glfwPollEvents();
+			updateInput();
+		}
 
-			char SHOOTTEXT[256];
-			sprintf(SHOOTTEXT, "Spacebar - Shoot");
-			printText2D(SHOOTTEXT, 210, 280, 20);
+		// Count this frame's draw calls
+		drawCalls = 0;
+		unsigned int textDrawCallsBefore = getText2DDrawCalls();
 
-			char PAUSETEXT[256];
-			sprintf(PAUSETEXT, "P - Pause Game");
-			printText2D(PAUSETEXT, 20, 200, 20);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear the screen
 
-			char PLAYERCAMERATEXT[256];
-			sprintf(PLAYERCAMERATEXT, "1 - Player Camera");
-			printText2D(PLAYERCAMERATEXT, 400, 200, 20);
+		glUseProgram(programID); // Use the shader program
 
-			char BATTLECAMERATEXT[256];
-			sprintf(BATTLECAMERATEXT, "2 - Front Camera");
-			printText2D(BATTLECAMERATEXT, 20, 120, 20);
+		handleGameStates(world);
 
-			char FREECAMERATEXT[256];
-			sprintf(FREECAMERATEXT, "3 - Free Camera");
-			printText2D(FREECAMERATEXT, 400, 120, 20);
+		// Menu screens only draw text, time them as the text pass
+		bool menuScreen = (world.state != GAME_PLAYING);
+		if (menuScreen)
+		{
+			beginGpuPass(GPU_PASS_TEXT);
+		}
 
-			char INSTRUCTIONSTEXT[256];
-			sprintf(INSTRUCTIONSTEXT, "Press ENTER to Start");
-			printText2D(INSTRUCTIONSTEXT, 20, 20, 35);
+		switch (world.state) {
 
 
+		case GAME_START:
+			renderStartScreen();
 			break;
 
 		case GAME_PAUSED:
@@ -1711,16 +1428,15 @@ int main(void)
 
 		case NEW_LEVEL_START:
 			// Start the next level
-			DEBUG_PRINT("HIGH SCORE -> " << HighScore);
-			DEBUG_PRINT("SCORE -> " << playerPoints);
+			LOG_DEBUG("HIGH SCORE -> %d", world.highScore);
+			LOG_DEBUG("SCORE -> %d", world.playerPoints);
 
-			if (playerPoints > HighScore)
+			if (world.playerPoints > world.highScore)
 			{
-				HighScore = playerPoints;
+				world.highScore = world.playerPoints;
 			}
-			effectclean(explosions, lasers); // Clean up explosions and lasers
-			LEVELMANAGER.startNextLevel();
-			currentState = GAME_PLAYING;
+			loadWorldLevel(world, world.levelNumber + 1); // Lasers and explosions of the last level go with it
+			world.state = GAME_PLAYING;
 			break;
 		case GAME_OVER:
 
@@ -1729,11 +1445,11 @@ int main(void)
 			printText2D(GAMEOVERTEXT, 20, 500, 50);
 
 			char FINALSCORETEXT[256];
-			sprintf(FINALSCORETEXT, "Your Score: %d", playerPoints);
+			sprintf(FINALSCORETEXT, "Your Score: %d", world.playerPoints);
 			printText2D(FINALSCORETEXT, 20, 300, 25);
 
 			char HIGHSCORETEXT[256];
-			sprintf(HIGHSCORETEXT, "Highscore: %d", HighScore);
+			sprintf(HIGHSCORETEXT, "Highscore: %d", world.highScore);
 			printText2D(HIGHSCORETEXT, 20, 200, 25);
 
 			char RESTARTTEXT[256];
@@ -1745,19 +1461,19 @@ int main(void)
 
 		case GAME_RESET:
 			// Reset the game
-			if (playerPoints > HighScore)
+			if (world.playerPoints > world.highScore)
 			{
-				HighScore = playerPoints;
+				world.highScore = world.playerPoints;
 			}
-			playerPoints = 0;
-			LEVELMANAGER.resetLevel();
-			currentState = GAME_PLAYING;
+			world.playerPoints = 0;
+			loadWorldLevel(world, 1);
+			world.state = GAME_PLAYING;
 			break;
 		case GAME_PLAYING:
 
 
 			// Calculate the view and projection matrices
-			computeMatricesFromInput(LEVELMANAGER.currentLevel->playerShip.position);
+			computeMatricesFromInput(world.level->playerShip.position);
 			glm::mat4 ProjectionMatrix = getProjectionMatrix();
 			glm::mat4 ViewMatrix = getViewMatrix();
 
@@ -1769,162 +1485,145 @@ int main(void)
 			lastTime = currentTime; // Update lastTime
 
 
-			// Handle player movement (keyboard input)
-			handlePlayerMovement(LEVELMANAGER.currentLevel->playerShip, deltaTime);
-
-			// Update alien positions
-			updateAlienPositions(LEVELMANAGER.currentLevel->aliens);
+			// Time the simulation step for benchmark reports
+			std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
 
-			// Handle player blinking during invincibility period
-			if (isInvincible)
-			{
-				if (currentTime >= nextBlinkTime)
-				{
-					isBlinking = !isBlinking; // Toggle blinking state
-					nextBlinkTime = currentTime + BLINK_INTERVAL; // Set time for the next blink
-				}
-			}
-			else
-			{
-				isBlinking = false; // Ensure player is not blinking when not invincible
-			}
+			// Advance the game, with the keyboard or the scripted player when benchmarking at the controls.
+			// Recordings keep the time step with the keys, a replay steps exactly as the recorded game did
+			PlayerInput input = benchmark ? scriptedPlayerInput(world) : readPlayerInput();
+			world.step(input, inputTimeStep(deltaTime));
 
-			// Render player ship if not blinking
-			if (!isBlinking)
-			{
-				LEVELMANAGER.currentLevel->playerShip.modelMatrix = glm::translate(glm::mat4(1.0f), LEVELMANAGER.currentLevel->playerShip.position); // Update model matrix
-				LEVELMANAGER.currentLevel->playerShip.modelMatrix = glm::scale(LEVELMANAGER.currentLevel->playerShip.modelMatrix, glm::vec3(0.5f, 0.5f, 0.5f)); // Scale player ship
-				renderObject(LEVELMANAGER.currentLevel->playerShip, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix); // Render player ship
-			}
+			// Explosions started by the step go to the renderer's ring in one upload
+			spawnExplosions(world.explosions.data(), static_cast<int>(world.explosions.size()), world.time);
 
-			// Render mothership only if it's alive
-			if (mothershipAlive)
+			if (benchmark)
 			{
-				updateMothershipPosition(LEVELMANAGER.currentLevel->motherShip); // Update mothership position
-				LEVELMANAGER.currentLevel->motherShip.modelMatrix = glm::translate(glm::mat4(1.0f), LEVELMANAGER.currentLevel->motherShip.position); // Update model matrix
-				LEVELMANAGER.currentLevel->motherShip.modelMatrix = glm::scale(LEVELMANAGER.currentLevel->motherShip.modelMatrix, glm::vec3(0.5f, 0.5f, 0.5f)); // Scale mothership
-				renderObject(LEVELMANAGER.currentLevel->motherShip, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix); // Render mothership
-
-
-				// Handle mothership laser firing
-				handleMothershipLaserFiring(LEVELMANAGER.currentLevel->motherShip, mothership_laser_timer, LEVELMANAGER.currentLevel->playerShip);
-
-
-
-				// Handle laser-mothership collisions
-				handleLaserMothershipCollision(LEVELMANAGER.currentLevel->motherShip, explosions);
-
-
+				benchmarkResults.tickMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickStart).count());
 			}
 
-			// Render each alien dynamically
-			for (auto& alien : LEVELMANAGER.currentLevel->aliens)
-			{
-				alien.modelMatrix = glm::translate(glm::mat4(1.0f), alien.position); // Update alien position
-				renderObject(alien, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix); // Render alien
+			// Render everything inside the camera's view
+			renderScene(world, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix);
 
+			// Draw the lives, points and statistics overlay
+			renderHUD(world);
 
-				// Handle laser-alien collisions
-				handleLaserAlienCollisions(LEVELMANAGER.currentLevel->aliens, explosions);
+			break;
+		}
 
-				// Handle alien laser firing
-				handleAlienLaserFiring(LEVELMANAGER.currentLevel->aliens, LEVELMANAGER.currentLevel->playerShip.position, alien_laser_timer, LEVELMANAGER.currentLevel->playerShip);
+		if (menuScreen)
+		{
+			endGpuPass(GPU_PASS_TEXT);
+		}
 
+		glUseProgram(0); // Unbind the shader program
 
-			}
+		// Collect finished GPU timings, logged every few seconds while the statistics overlay is shown
+		endGpuFrame();
+		if (showStats && frameNumber % 300 == 0)
+		{
+			LOG_INFO("GPU ms: opaque %.3f explosions %.3f text %.3f", getGpuPassTime(GPU_PASS_OPAQUE), getGpuPassTime(GPU_PASS_EXPLOSIONS), getGpuPassTime(GPU_PASS_TEXT));
+			LOG_INFO("Memory KB: total %zu entities %zu mesh gpu %zu", memTotal() / 1024, memCurrent(MEM_ENTITIES) / 1024, memCurrent(MEM_MESH_GPU) / 1024);
+		}
 
-			for (auto& shield : LEVELMANAGER.currentLevel->shields)
+		// Write the finished frame to disk if requested
+		if (dumpDirectory)
+		{
+			char framePath[512];
+			snprintf(framePath, sizeof(framePath), "%s/frame_%06d.png", dumpDirectory, frameNumber);
+			if (!dumpFrame(framePath))
 			{
-				shield.obj.modelMatrix = glm::translate(glm::mat4(1.0f), shield.obj.position); // Update shield position
-				renderObject(shield.obj, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix, 5.0f); // Render shield
+				LOG_WARN("Failed to write frame: %s", framePath);
 			}
+		}
 
-			handleLaserShieldCollisions(LEVELMANAGER.currentLevel->shields);
+		presentFrame(); // Swap buffers to update the screen
+		if (pacing.lowLatency)
+		{
+			glFinish(); // Keep the CPU from queuing frames ahead of the GPU, they would show older input
+		}
 
+		// The presses this frame reacted to are the ones applied by the last input update
+		recordFramePresented(getOldestInputPress());
 
-			// Update and render lasers
-			for (auto& laser : lasers)
-			{
-				updateLaser(laser, deltaTime); // Update laser position
-			}
+		if (!pacing.lowLatency)
+		{
+			glfwPollEvents(); // Run the key callback for every event since the last frame
+			updateInput();    // Apply them to the actions the next frame reads
+		}
+		frameNumber++;
 
-			// Render lasers
-			for (auto& laser : lasers)
+		if (benchmark)
+		{
+			// Record the frame
+			std::chrono::steady_clock::time_point frameEnd = std::chrono::steady_clock::now();
+			benchmarkResults.frameMs.push_back(std::chrono::duration<double, std::milli>(frameEnd - lastFrameEnd).count());
+			benchmarkResults.drawCalls.push_back(drawCalls + static_cast<int>(getText2DDrawCalls() - textDrawCallsBefore));
+			lastFrameEnd = frameEnd;
+
+			// Nobody presses Enter or R during a benchmark: move on after a win, replay the level after a loss
+			if (world.state == NEW_LEVEL)
 			{
-				renderLaser(laser, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix); // Render each laser
+				benchmarkResults.levelsCleared++;
+				world.state = NEW_LEVEL_START;
 			}
-
-
-
-
-			// Update and render explosions
-			updateExplosions(explosions);
-
-
-			// Render explosions
-			for (auto& explosion : explosions)
+			else if (world.state == GAME_OVER)
 			{
-				renderExplosions(explosion, MatrixID, ModelMatrixID, ViewMatrixID, textureID, ProjectionMatrix, ViewMatrix); // Render each explosion
-			}
-
-
-
-
-
-			// Handle player laser collisions
-			LEVELMANAGER.currentLevel->playerHealth = handleLaserPlayerCollisions(LEVELMANAGER.currentLevel->playerShip, LEVELMANAGER.currentLevel->playerHealth);
-
-
-
-
-
-			// Check if all aliens are dead
-			if (LEVELMANAGER.currentLevel->aliens.empty())
-			{
-				DEBUG_PRINT("LEVEL WON!");
-				DEBUG_PRINT("POINTS -> " << playerPoints);
-				currentState = NEW_LEVEL; // Transition to the new level state
+				benchmarkResults.gamesLost++;
+				world.playerPoints = 0;
+				loadWorldLevel(world, config.level);
+				if (!startSnapshot.empty())
+				{
+					restoreSnapshot(world, startSnapshot.data(), startSnapshot.size());
+				}
+				world.state = GAME_PLAYING;
 			}
 
-
-
-
-
-			char life_text[256];
-			sprintf(life_text, "LIFES %d", LEVELMANAGER.currentLevel->playerHealth);
-			printText2D(life_text, 20, 20, 25);
-
-			char points_text[256];
-			sprintf(points_text, "POINTS %d", playerPoints);
-			printText2D(points_text, 450, 20, 25);
-
-
-
-			break;
+			benchmarkDone = (glfwGetTime() - benchmarkStart) >= config.duration;
 		}
 
-		glUseProgram(0); // Unbind the shader program
-		glfwSwapBuffers(window); // Swap buffers to update the screen
-		glfwPollEvents(); // Process input events
 
+	} while (!isActionDown(ACTION_QUIT) && // Exit if the ESC key is pressed
+		glfwWindowShouldClose(window) == 0 && // Exit if the window is closed
+		(maxFrames <= 0 || frameNumber < maxFrames) && // Exit after the requested number of frames
+		!benchmarkDone); // Exit when the benchmark's duration is over
 
+	if (world.playerPoints > world.highScore)
+	{
+		world.highScore = world.playerPoints;
+	}
 
-	} while (glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS && // Exit if the ESC key is pressed
-		glfwWindowShouldClose(window) == 0); // Exit if the window is closed
+	LOG_INFO("HIGH SCORE -> %d", world.highScore);
 
-	if (playerPoints > HighScore)
+	// Write the benchmark report, a failed write fails the run
+	int result = 0;
+	if (benchmark)
 	{
-		HighScore = playerPoints;
+		if (writeBenchmarkReport(reportPath, config, benchmarkResults))
+		{
+			printf("Benchmark: %d frames, p50 %.2f ms, p99 %.2f ms, report written to %s\n", static_cast<int>(benchmarkResults.frameMs.size()),
+				percentile(benchmarkResults.frameMs, 0.50), percentile(benchmarkResults.frameMs, 0.99), reportPath);
+		}
+		else
+		{
+			result = 1;
+		}
 	}
 
-	DEBUG_PRINT("HIGH SCORE -> " << HighScore);
-
+	cleanupGpuTimers(); // Delete the GPU timer queries
 	cleanupText2D(); // Clean up text resources
-	effectclean(explosions, lasers); // Clean up explosions and lasers
-	objCache.clear();
+	world.unloadLevel(); // Delete the level and its lasers
+	for (GameObject& obj : modelObjects)
+	{
+		cleanupGameObject(obj); // Delete the model buffers before the context goes away
+	}
+	cleanupExplosions(); // Delete the explosion mesh, instance buffer and shader
+	cleanupLaserBatch(); // Delete the laser mesh, instance buffer and shader
+	clearObjCache();
 	glDeleteProgram(programID); // Delete shader program
-	glfwTerminate(); // Terminate GLFW
-	return 0; // Exit the program
+	reportInputLatency(); // Log how long key presses took to reach the screen
+	cleanupInput(); // Close the input recording
+	cleanupBackend(); // Destroy the offscreen framebuffer and terminate GLFW
+	return result; // Exit the program
 }
 
 
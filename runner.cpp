@@ -0,0 +1,374 @@
+// Batch runner: plays many independent games at once with a bot at the controls, without a window or OpenGL.
+// Each game is a World stepped at a fixed time step as fast as the CPU allows, worker threads take games
+// from a shared counter until every game is played. Prints (and optionally writes as JSON) score and
+// survival statistics, with the throughput in games per second.
+#include <atomic>                   // Shared game counter of the workers
+#include <chrono>                   // Wall clock time of the run
+#include <stdio.h>                  // Standard input/output operations
+#include <stdlib.h>                 // Standard library functions
+#include <string>                   // Strings for command line parsing
+#include <thread>                   // Worker threads
+#include <vector>                   // Vector container from the Standard Template Library (STL)
+
+#include <glm/glm.hpp>              // GLM header for mathematical operations on vectors and matrices
+
+#include "common/levelfile.hpp"     // Level definitions loaded from the level file
+#include "common/collision.hpp"     // Bounding volumes of the models
+#include "common/benchmark.hpp"     // Percentiles of the results
+#include "common/log.hpp"           // Leveled asynchronous logging
+#include "common/world.hpp"         // Game simulation: levels, entities, collisions and rules
+#include "common/bots.hpp"          // Bot policies driving the player
+#include "common/snapshot.hpp"      // Binary copies of a world's state
+
+// Include TinyObjLoader for reading the vertices of the .obj models, only their bounds are kept
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "common/tiny_obj_loader.h"
+
+
+// Settings of a run, given on the command line
+struct RunnerConfig
+{
+	int games = 1000;             // Games to play
+	int threads = 0;              // Worker threads, 0 = one per hardware thread
+	const BotDefinition * bot = NULL; // Policy at the controls (--bot)
+	unsigned int seed = 1;        // Seed of the first game, game i is seeded with seed + i
+	int level = 1;                // Level every game starts on
+	double maxTime = 600.0;       // Seconds of gameplay after which a game still going is stopped
+	float step = 1.0f / 60.0f;    // Fixed simulation time step in seconds
+	std::vector<unsigned char> start; // Snapshot every game starts from (--snapshot), empty = the start of level
+};
+
+// Outcome of one game
+struct GameResult
+{
+	int score = 0;                // Points when the game ended
+	int levelsCleared = 0;        // Levels won
+	double survivalTime = 0.0;    // Seconds of gameplay when the game ended, including the time before its starting snapshot
+	bool died = false;            // Lost (game over) rather than stopped at maxTime
+	long long steps = 0;          // Simulation steps taken
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to read the bounds of every model from its OBJ file, without loading textures or uploading anything
+bool loadModelBounds(Bounds bounds[MODEL_COUNT])
+{
+	for (int model = 0; model < MODEL_COUNT; model++)
+	{
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+		std::vector<tinyobj::material_t> materials;
+		std::string warn, err;
+		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, modelFiles[model].objFile, modelFiles[model].mtlFile))
+		{
+			LOG_ERROR("Failed to load %s: %s", modelFiles[model].objFile, err.c_str());
+			return false;
+		}
+
+		// The same vertices the renderer uploads, so the bounds match the game's exactly
+		std::vector<glm::vec3> vertices;
+		for (const auto& shape : shapes)
+		{
+			for (const auto& index : shape.mesh.indices)
+			{
+				vertices.push_back(glm::vec3(attrib.vertices[3 * index.vertex_index + 0],
+					attrib.vertices[3 * index.vertex_index + 1],
+					attrib.vertices[3 * index.vertex_index + 2]));
+			}
+		}
+		bounds[model] = computeBounds(vertices);
+	}
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to start a game on the configured level, or from the starting snapshot if there is one
+void startGame(const RunnerConfig & config, World & world)
+{
+	world.state = GAME_PLAYING;
+	world.startLevel(config.level);
+	if (!config.start.empty())
+	{
+		restoreSnapshot(world, config.start.data(), config.start.size());
+	}
+}
+
+// Function to step a game with the configured bot until it is lost or endTime seconds of gameplay have passed
+void playUntil(const RunnerConfig & config, World & world, BotState & bot, double endTime, GameResult & result)
+{
+	while (world.time < endTime && world.state == GAME_PLAYING)
+	{
+		world.step(config.bot->policy(world, bot), config.step);
+		result.steps++;
+
+		if (world.state == NEW_LEVEL)
+		{
+			// No menu in between, the next level starts right away
+			result.levelsCleared++;
+			world.startNextLevel();
+			world.state = GAME_PLAYING;
+		}
+	}
+
+	result.died = (world.state == GAME_OVER);
+	result.score = world.playerPoints;
+	result.survivalTime = world.time;
+}
+
+// Function to play one game to its end (or to maxTime) with the configured bot
+GameResult playGame(const RunnerConfig & config, const std::vector<LevelDefinition> & definitions, const Bounds * modelBounds, unsigned int seed)
+{
+	// The default memory resource: the memory statistics are not thread-safe, so no game accounts its levels
+	World world(definitions, modelBounds, seed);
+	BotState bot;
+	seedBot(bot, seed);
+	startGame(config, world);
+
+	// Games fast-forwarded to the same snapshot only differ by their random sequence from there on
+	if (!config.start.empty())
+	{
+		world.seedRandom(seed);
+	}
+
+	GameResult result;
+	playUntil(config, world, bot, config.maxTime, result);
+	return result;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Function to compute the mean of a set of samples
+static double mean(const std::vector<double> & samples)
+{
+	double sum = 0.0;
+	for (double sample : samples)
+		sum += sample;
+	return samples.empty() ? 0.0 : sum / samples.size();
+}
+
+// Function to print the statistics of the run and write them as JSON if a path is given
+bool reportResults(const RunnerConfig & config, int threads, const std::vector<GameResult> & results, double wallSeconds, const char * reportPath)
+{
+	std::vector<double> scores, levels, survivalTimes, deathTimes;
+	long long steps = 0;
+	double gameSeconds = 0.0;
+	for (const GameResult & result : results)
+	{
+		scores.push_back(result.score);
+		levels.push_back(result.levelsCleared);
+		survivalTimes.push_back(result.survivalTime);
+		if (result.died)
+			deathTimes.push_back(result.survivalTime);
+		steps += result.steps;
+		gameSeconds += result.steps * config.step;
+	}
+
+	double gamesPerSecond = results.size() / wallSeconds;
+	double survivalRate = results.empty() ? 0.0 : 1.0 - static_cast<double>(deathTimes.size()) / results.size();
+
+	printf("Bot %s, %d games on %d threads in %.2f s\n", config.bot->name, static_cast<int>(results.size()), threads, wallSeconds);
+	printf("  Throughput     %10.1f games/s  %12.0f steps/s  %8.0fx real time\n", gamesPerSecond, steps / wallSeconds, gameSeconds / wallSeconds);
+	printf("  Score          mean %8.1f  p50 %8.0f  p90 %8.0f  max %8.0f\n", mean(scores), percentile(scores, 0.50), percentile(scores, 0.90), percentile(scores, 1.0));
+	printf("  Levels cleared mean %8.2f  p50 %8.0f  p90 %8.0f  max %8.0f\n", mean(levels), percentile(levels, 0.50), percentile(levels, 0.90), percentile(levels, 1.0));
+	printf("  Survival       %5.1f%% reached %.0f s, mean time %.1f s, mean time of lost games %.1f s\n",
+		survivalRate * 100.0, config.maxTime, mean(survivalTimes), mean(deathTimes));
+
+	if (!reportPath)
+	{
+		return true;
+	}
+
+	FILE * file = fopen(reportPath, "w");
+	if (!file)
+	{
+		printf("Impossible to open runner report %s\n", reportPath);
+		return false;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"config\": { \"bot\": \"%s\", \"games\": %d, \"threads\": %d, \"seed\": %u, \"level\": %d, \"max_time\": %.2f, \"step\": %.6f },\n",
+		config.bot->name, static_cast<int>(results.size()), threads, config.seed, config.level, config.maxTime, config.step);
+	fprintf(file, "  \"wall_seconds\": %.4f,\n", wallSeconds);
+	fprintf(file, "  \"games_per_second\": %.2f,\n", gamesPerSecond);
+	fprintf(file, "  \"steps_per_second\": %.0f,\n", steps / wallSeconds);
+	fprintf(file, "  \"score\": { \"mean\": %.2f, \"p50\": %.0f, \"p90\": %.0f, \"max\": %.0f },\n",
+		mean(scores), percentile(scores, 0.50), percentile(scores, 0.90), percentile(scores, 1.0));
+	fprintf(file, "  \"levels_cleared\": { \"mean\": %.3f, \"p50\": %.0f, \"p90\": %.0f, \"max\": %.0f },\n",
+		mean(levels), percentile(levels, 0.50), percentile(levels, 0.90), percentile(levels, 1.0));
+	fprintf(file, "  \"survival\": { \"rate\": %.4f, \"mean_seconds\": %.2f, \"mean_seconds_lost\": %.2f }\n",
+		survivalRate, mean(survivalTimes), mean(deathTimes));
+	fprintf(file, "}\n");
+
+	bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	startLog();
+
+	// Parse the command line
+	RunnerConfig config;
+	config.bot = findBot("chaser");
+	const char* reportPath = NULL;           // Where the JSON report is written (--report)
+	const char* snapshotPath = NULL;         // Snapshot every game starts from (--snapshot)
+	const char* savePath = NULL;             // Where the snapshot of a game is saved (--save-snapshot)
+	double saveTime = 60.0;                  // Seconds of gameplay after which the game is saved (--at)
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--games" && i + 1 < argc)
+		{
+			config.games = atoi(argv[++i]);
+		}
+		else if (arg == "--threads" && i + 1 < argc)
+		{
+			config.threads = atoi(argv[++i]);
+		}
+		else if (arg == "--bot" && i + 1 < argc)
+		{
+			config.bot = findBot(argv[++i]);
+			if (!config.bot)
+			{
+				printf("Unknown bot %s\n", argv[i]);
+				return -1;
+			}
+		}
+		else if (arg == "--seed" && i + 1 < argc)
+		{
+			config.seed = static_cast<unsigned int>(strtoul(argv[++i], NULL, 10));
+		}
+		else if (arg == "--level" && i + 1 < argc)
+		{
+			config.level = atoi(argv[++i]);
+		}
+		else if (arg == "--max-time" && i + 1 < argc)
+		{
+			config.maxTime = atof(argv[++i]);
+		}
+		else if (arg == "--step" && i + 1 < argc)
+		{
+			config.step = static_cast<float>(atof(argv[++i]));
+		}
+		else if (arg == "--report" && i + 1 < argc)
+		{
+			reportPath = argv[++i];
+		}
+		else if (arg == "--snapshot" && i + 1 < argc)
+		{
+			snapshotPath = argv[++i];
+		}
+		else if (arg == "--save-snapshot" && i + 1 < argc)
+		{
+			savePath = argv[++i];
+		}
+		else if (arg == "--at" && i + 1 < argc)
+		{
+			saveTime = atof(argv[++i]);
+		}
+		else
+		{
+			printf("Usage: %s [--games N] [--threads N] [--bot NAME] [--seed N] [--level N] [--max-time SECONDS] [--step SECONDS] [--report FILE]\n"
+				"          [--snapshot FILE] [--save-snapshot FILE [--at SECONDS]]\n", argv[0]);
+			printf("Bots:\n");
+			for (int bot = 0; bot < BOT_COUNT; bot++)
+			{
+				printf("  %-8s %s\n", botDefinitions[bot].name, botDefinitions[bot].description);
+			}
+			return -1;
+		}
+	}
+
+	if (config.games <= 0 || config.threads < 0 || config.level < 1 || config.maxTime <= 0.0 || config.step <= 0.0f)
+	{
+		printf("Invalid --games, --threads, --level, --max-time or --step value\n");
+		return -1;
+	}
+
+	int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+	if (threads <= 0)
+	{
+		threads = 1;
+	}
+	if (threads > config.games)
+	{
+		threads = config.games;
+	}
+
+	// Everything the games share is loaded once and only read while they run
+	std::vector<LevelDefinition> definitions;
+	if (!loadLevelFile("levels/levels.txt", definitions))
+	{
+		LOG_WARN("Using built-in levels");
+		makeDefaultLevels(definitions, 10);
+	}
+	Bounds modelBounds[MODEL_COUNT];
+	if (!loadModelBounds(modelBounds))
+	{
+		return -1;
+	}
+
+	// Thousands of games would flood the log with their level and hit messages
+	setLogLevel(LOG_LEVEL_WARN);
+
+	// Check the starting snapshot once, every game restores the same one
+	if (snapshotPath)
+	{
+		World check(definitions, modelBounds, config.seed);
+		if (!readSnapshotFile(snapshotPath, config.start) || !restoreSnapshot(check, config.start.data(), config.start.size()))
+		{
+			printf("Invalid snapshot %s\n", snapshotPath);
+			return -1;
+		}
+	}
+
+	// Saving plays a single game (seed) up to the given time and writes it, to be fast-forwarded to with --snapshot
+	if (savePath)
+	{
+		World world(definitions, modelBounds, config.seed);
+		BotState bot;
+		seedBot(bot, config.seed);
+		startGame(config, world);
+		GameResult result;
+		playUntil(config, world, bot, saveTime, result);
+
+		std::vector<unsigned char> snapshot;
+		saveSnapshot(world, snapshot);
+		if (!writeSnapshotFile(savePath, snapshot))
+		{
+			return -1;
+		}
+		printf("Saved level %d at %.1f s with %d points to %s (%d bytes)\n", world.levelNumber, world.time, world.playerPoints, savePath, static_cast<int>(snapshot.size()));
+		return 0;
+	}
+
+	// Every worker takes the next game until none is left, each result has its own slot so nothing else is shared
+	std::vector<GameResult> results(config.games);
+	std::atomic<int> nextGame(0);
+	auto worker = [&]()
+	{
+		for (int game = nextGame.fetch_add(1); game < config.games; game = nextGame.fetch_add(1))
+		{
+			results[game] = playGame(config, definitions, modelBounds, config.seed + game);
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.emplace_back(worker);
+	}
+	for (std::thread & thread : workers)
+	{
+		thread.join();
+	}
+	double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	setLogLevel(LOG_LEVEL_TRACE);
+	return reportResults(config, threads, results, wallSeconds, reportPath) ? 0 : -1;
+}